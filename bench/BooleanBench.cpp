@@ -0,0 +1,169 @@
+// 多边形布尔运算基准：两个顶点数成倍增加的波浪形轮廓（如折线化的曲线）互相错开，分别求交、并、差、异或，
+// 报告耗时并用面积关系校验结果：|A∪B| + |A∩B| = |A| + |B|，|A-B| = |A| - |A∩B|，|A⊕B| = |A∪B| - |A∩B|
+// （结果顶点就近取整，允许相对误差 1e-3）。
+// 再让两把齿数成倍增加、长齿沿 x 方向交错插入的梳子做同样的运算（扫描线上同时有大量活动边，
+// 每个 clip 齿尖伸入 subject 的底边，交集恰好是每个齿尖一个矩形）。
+// 另取一个轮廓完全落在另一个内部的情形，确认差集的洞被分组到外环中，两种填充算法都不填充洞内
+// 用法：BooleanBench [最大顶点数]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "DrawingAlgorithm.h"
+#include "PolygonBoolean.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// 以 (cx, cy) 为中心、半径按 radius + amplitude·sin(waves·θ) 起伏的 n 顶点轮廓
+std::vector<Point> Wave(int n, int cx, int cy, double radius, double amplitude, int waves) {
+    std::vector<Point> poly;
+    for (int k = 0; k < n; k++) {
+        double angle = 2 * 3.14159265358979323846 * k / n;
+        double r = radius + amplitude * sin(waves * angle);
+        poly.push_back(Point((int)lrint(cx + r * cos(angle)), (int)lrint(cy + r * sin(angle))));
+    }
+    return poly;
+}
+
+// teeth 个齿的梳子：底边在 [baseX, baseX + dir * BASE]，齿宽 TOOTH、间距 PITCH，从底边向 dir 方向伸到 tipX；
+// 第 k 个齿的下边在 y0 + k * PITCH
+const int PITCH = 20, TOOTH = 8, BASE = 10;
+std::vector<Point> Comb(int teeth, int y0, int baseX, int dir, int tipX) {
+    int length = teeth * PITCH + PITCH;
+    int rootX = baseX + dir * BASE;
+    std::vector<Point> poly = { Point(baseX, y0 - PITCH), Point(baseX, y0 - PITCH + length), Point(rootX, y0 - PITCH + length) };
+    for (int k = teeth - 1; k >= 0; k--) {
+        int y = y0 + k * PITCH;
+        poly.push_back(Point(rootX, y + TOOTH));
+        poly.push_back(Point(tipX, y + TOOTH));
+        poly.push_back(Point(tipX, y));
+        poly.push_back(Point(rootX, y));
+    }
+    poly.push_back(Point(rootX, y0 - PITCH));
+    return poly;
+}
+
+// 环的有向面积之和（洞为负）
+double Area(const PolygonBoolean::Rings& rings) {
+    double sum = 0;
+    for (const auto& r : rings) {
+        for (size_t i = 0, j = r.size() - 1; i < r.size(); j = i++) {
+            sum += (double)r[j].x * r[i].y - (double)r[i].x * r[j].y;
+        }
+    }
+    return sum / 2;
+}
+
+// 分组后每一项的第一个环为外环（面积为正），其余为洞（面积为负），总面积与分组前相同
+bool CheckGroups(const PolygonBoolean::Rings& rings, const std::vector<PolygonBoolean::Rings>& groups, size_t& holes) {
+    double total = 0;
+    size_t count = 0;
+    holes = 0;
+    for (const auto& group : groups) {
+        if (Area({ group[0] }) <= 0) return false;
+        for (size_t i = 1; i < group.size(); i++) {
+            if (Area({ group[i] }) >= 0) return false;
+        }
+        total += Area(group);
+        count += group.size();
+        holes += group.size() - 1;
+    }
+    return count == rings.size() && fabs(total - Area(rings)) < 1e-6 * (1 + fabs(total));
+}
+
+}
+
+int main(int argc, char** argv) {
+    int maxVertices = argc > 1 ? atoi(argv[1]) : 200000;
+    const char* names[] = { "intersection", "union", "difference", "xor" };
+
+    PolygonBoolean engine;
+    bool ok = true;
+
+    // 四种运算各算一次，报告耗时并校验面积关系和结果环的分组；返回交集的环数
+    auto run = [&](const char* label, int n, const PolygonBoolean::Rings& a, const PolygonBoolean::Rings& b) {
+        double areaA = fabs(Area(a)), areaB = fabs(Area(b));
+        double areas[4];
+        size_t intersections = 0;
+        for (int op = 0; op < 4; op++) {
+            PolygonBoolean::Rings result;
+            Timer timer;
+            engine.Compute(a, b, (BooleanOp)op, result);
+            double ms = timer.ElapsedMs();
+            size_t vertices = 0;
+            for (const auto& r : result) vertices += r.size();
+            areas[op] = Area(result);
+            if (op == 0) intersections = result.size();
+            printf("%-5s %7d x 2 %-13s %9.2f ms  rings %6zu  vertices %7zu\n", label, n, names[op], ms, result.size(), vertices);
+
+            std::vector<PolygonBoolean::Rings> groups;
+            size_t holes;
+            PolygonBoolean::GroupRings(result, groups);
+            if (!CheckGroups(result, groups, holes)) {
+                printf("        %s ring grouping FAILED\n", names[op]);
+                ok = false;
+            }
+        }
+
+        double scale = areaA + areaB;
+        double errors[3] = {
+            fabs(areas[1] + areas[0] - areaA - areaB),
+            fabs(areas[2] - (areaA - areas[0])),
+            fabs(areas[3] - (areas[1] - areas[0])),
+        };
+        bool pass = errors[0] < scale * 1e-3 && errors[1] < scale * 1e-3 && errors[2] < scale * 1e-3;
+        printf("        area check %s (relative error %.2e)\n", pass ? "OK" : "FAILED",
+               std::max(errors[0], std::max(errors[1], errors[2])) / scale);
+        ok = ok && pass;
+        return intersections;
+    };
+
+    for (int n = 1000; n <= maxVertices; n *= 10) {
+        run("wave", n, { Wave(n, 20000, 20000, 15000, 2000, 40) }, { Wave(n, 23000, 21000, 14000, 3000, 25) });
+    }
+    for (int n = 1000; n <= maxVertices; n *= 10) {
+        int teeth = n / 4;
+        size_t tips = run("comb", n, { Comb(teeth, 0, 0, 1, 50000) }, { Comb(teeth, PITCH / 2, 50030, -1, BASE / 2) });
+        if (tips != (size_t)teeth) {
+            printf("        expected %d intersection rings  FAILED\n", teeth);
+            ok = false;
+        }
+    }
+
+    // 差集 A - B，B 完全在 A 内部：结果是一个带洞的多边形
+    {
+        PolygonBoolean::Rings a = { Wave(1000, 200, 200, 150, 20, 40) };
+        PolygonBoolean::Rings b = { Wave(1000, 200, 200, 60, 10, 25) };
+        PolygonBoolean::Rings result;
+        engine.Compute(a, b, BooleanOp::Difference, result);
+        std::vector<PolygonBoolean::Rings> groups;
+        size_t holes;
+        PolygonBoolean::GroupRings(result, groups);
+        bool pass = CheckGroups(result, groups, holes) && groups.size() == 1 && holes == 1;
+
+        // 洞的中心不填充，外环与洞之间填充
+        const FillAlgorithm fillAlgos[] = { FillAlgorithm::ScanLine, FillAlgorithm::Fence };
+        RasterTarget target(400, 400);
+        uint32_t fill = RasterTarget::ToPixel(RGB(135, 206, 250));
+        for (int k = 0; k < 2 && pass; k++) {
+            target.Clear(0xFFFFFF);
+            PolygonBoolean::Rings holeRings(groups[0].begin() + 1, groups[0].end());
+            DrawingAlgorithm::FillPolygon(target, groups[0][0], holeRings, fillAlgos[k], RGB(135, 206, 250));
+            pass = target.Row(200)[200] != fill && target.Row(200)[305] == fill;
+        }
+        printf("nested difference  polygons %zu  rings %zu  hole fill %s\n", groups.size(), result.size(),
+               pass ? "OK" : "FAILED");
+        ok = ok && pass;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// Weiler-Atherton 多边形裁剪基准：随机多边形依次对矩形和凸五边形裁剪，矩形再走一次快速路径并确认结果一致，
+// 报告耗时、输出校验和以及顶点分配统计（顶点数即逐个 new 时的分配次数，另一项为顶点图数组扩容的次数，
+// 不含每次裁剪返回结果时的分配）；
+// 再把顶点数成倍增加的锯齿星形多边形对 1000 边的星形裁剪，观察扫描求交的规模增长，
+// 以及两把齿数相同、长齿交错插入的梳子（对方的齿只与自己的底边相交，其余长边 y 范围全部重叠而 x 互不重叠），
+// 不超过 10000 顶点时再两两求交一次，确认交点数与结果都与扫描求交相同
+// 用法：ClipBench [多边形数 轮数 最大顶点数]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "WeilerAtherton.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// 以 (cx, cy) 为中心、半径在 [inner, outer] 间交替的 n 顶点星形
+std::vector<Point> Star(int n, int cx, int cy, double inner, double outer) {
+    std::vector<Point> poly;
+    for (int k = 0; k < n; k++) {
+        double angle = 2 * 3.14159265358979323846 * k / n;
+        double r = k % 2 ? inner : outer;
+        poly.push_back(Point((int)lrint(cx + r * cos(angle)), (int)lrint(cy + r * sin(angle))));
+    }
+    return poly;
+}
+
+// 裁剪结果的校验和
+uint64_t Checksum(const std::vector<std::vector<Point>>& pieces, uint64_t hash = 1469598103934665603ull) {
+    for (const auto& piece : pieces) {
+        for (const auto& p : piece) {
+            hash = (hash ^ (uint32_t)p.x) * 1099511628211ull;
+            hash = (hash ^ (uint32_t)p.y) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// teeth 个齿的梳子：底边在 [baseY, baseY + dir * BASE]，齿宽 TOOTH、间距 PITCH，从底边向 dir 方向伸到 tipY；
+// 第 k 个齿的左边在 x0 + k * PITCH
+const int PITCH = 20, TOOTH = 8, BASE = 10;
+std::vector<Point> Comb(int teeth, int x0, int baseY, int dir, int tipY) {
+    int length = teeth * PITCH + PITCH;
+    int rootY = baseY + dir * BASE;
+    std::vector<Point> poly = { Point(x0 - PITCH, baseY), Point(x0 - PITCH + length, baseY), Point(x0 - PITCH + length, rootY) };
+    for (int k = teeth - 1; k >= 0; k--) {
+        int x = x0 + k * PITCH;
+        poly.push_back(Point(x + TOOTH, rootY));
+        poly.push_back(Point(x + TOOTH, tipY));
+        poly.push_back(Point(x, tipY));
+        poly.push_back(Point(x, rootY));
+    }
+    poly.push_back(Point(x0 - PITCH, rootY));
+    return poly;
+}
+
+// 两两求交一次，与扫描求交的交点数和结果比较
+bool MatchesPairwise(const std::vector<Point>& subject, const std::vector<Point>& clip,
+                     size_t crossings, const std::vector<std::vector<Point>>& pieces) {
+    size_t before = WeilerAtherton::GetAllocationStats().vertices;
+    Timer timer;
+    auto reference = WeilerAtherton::clip(subject, clip, CrossingSearch::PAIRWISE);
+    double ms = timer.ElapsedMs();
+    size_t pairwiseCrossings = (WeilerAtherton::GetAllocationStats().vertices - before - subject.size() - clip.size()) / 2;
+    bool same = pairwiseCrossings == crossings && Checksum(reference) == Checksum(pieces);
+    printf("     pairwise %9.2f ms  crossings %zu  %s\n", ms, pairwiseCrossings, same ? "same result" : "MISMATCH");
+    return same;
+}
+
+
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 10000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+
+    std::mt19937 rng(2024);
+    std::vector<std::vector<Point>> subjects;
+    for (int i = 0; i < count; i++) {
+        int cx = (int)(rng() % 1000), cy = (int)(rng() % 800), size = 5 + (int)(rng() % 200);
+        int n = 3 + (int)(rng() % 14);
+        std::vector<Point> poly;
+        for (int k = 0; k < n; k++) {
+            poly.push_back(Point(cx + (int)(rng() % (2 * size)) - size, cy + (int)(rng() % (2 * size)) - size));
+        }
+        subjects.push_back(poly);
+    }
+    const std::vector<std::vector<Point>> windows = {
+        { Point(200, 150), Point(800, 150), Point(800, 650), Point(200, 650) },
+        { Point(200, 200), Point(600, 100), Point(900, 400), Point(500, 750), Point(150, 600) },
+    };
+    const Rect rect(Point(200, 150), Point(800, 650));   // 与 0 号窗口相同，走矩形快速路径
+
+    uint64_t checksums[3];
+    for (size_t w = 0; w < 3; w++) {
+        WeilerAtherton::AllocationStats before = WeilerAtherton::GetAllocationStats();
+        uint64_t hash = 1469598103934665603ull;
+        size_t pieces = 0;
+        Timer timer;
+        for (int r = 0; r < rounds; r++) {
+            for (const auto& subject : subjects) {
+                auto result = w < windows.size() ? WeilerAtherton::clip(subject, windows[w]) : WeilerAtherton::clip(subject, rect);
+                pieces += result.size();
+                hash = Checksum(result, hash);
+            }
+        }
+        double ms = timer.ElapsedMs();
+        WeilerAtherton::AllocationStats after = WeilerAtherton::GetAllocationStats();
+        checksums[w] = hash;
+        if (w < windows.size()) printf("window %zu: ", w);
+        else printf("rect fast:");
+        printf("%d x %d clips %9.2f ms  pieces %zu  checksum %016llx%s\n", rounds, count, ms, pieces,
+               (unsigned long long)hash, w == windows.size() && hash != checksums[0] ? "  MISMATCH" : "");
+        printf("          vertices %zu  graph array growths %zu\n",
+               after.vertices - before.vertices, after.graphArrayGrowths - before.graphArrayGrowths);
+    }
+
+    // 大多边形：边数之积远超阈值，走扫描求交；图中的顶点数减去两多边形的顶点数即两倍的交点数
+    int maxVertices = argc > 3 ? atoi(argv[3]) : 100000;
+    const std::vector<Point> star = Star(1000, 2000, 2000, 1500, 1800);
+    bool sweepOk = true;
+    for (int n = 1000; n <= maxVertices; n *= 10) {
+        std::vector<Point> subject = Star(n, 2300, 2100, 1200, 1700);
+        size_t before = WeilerAtherton::GetAllocationStats().vertices;
+        Timer timer;
+        auto pieces = WeilerAtherton::clip(subject, star);
+        double ms = timer.ElapsedMs();
+        size_t crossings = (WeilerAtherton::GetAllocationStats().vertices - before - subject.size() - star.size()) / 2;
+        size_t vertices = 0;
+        for (const auto& piece : pieces) vertices += piece.size();
+        printf("star %7d x %d %9.2f ms  crossings %zu  pieces %zu  vertices %zu\n",
+               n, (int)star.size(), ms, crossings, pieces.size(), vertices);
+
+        if (n <= 10000) sweepOk = MatchesPairwise(subject, star, crossings, pieces) && sweepOk;
+    }
+
+    // 交错的梳子：subject 的齿向上、clip 的齿向下插入 subject 的底边，每个 clip 齿与 subject 底边交于两点
+    for (int n = 1000; n <= maxVertices; n *= 10) {
+        int teeth = n / 4;
+        std::vector<Point> subject = Comb(teeth, 0, 0, 1, 50000);
+        std::vector<Point> clip = Comb(teeth, PITCH / 2, 50030, -1, BASE / 2);
+        size_t before = WeilerAtherton::GetAllocationStats().vertices;
+        Timer timer;
+        auto pieces = WeilerAtherton::clip(subject, clip);
+        double ms = timer.ElapsedMs();
+        size_t crossings = (WeilerAtherton::GetAllocationStats().vertices - before - subject.size() - clip.size()) / 2;
+        printf("comb %7zu x %zu %9.2f ms  crossings %zu  pieces %zu\n",
+               subject.size(), clip.size(), ms, crossings, pieces.size());
+        bool expected = crossings == 2 * (size_t)teeth;
+        if (!expected) printf("     expected %d crossings  MISMATCH\n", 2 * teeth);
+        sweepOk = sweepOk && expected;
+        if (n <= 10000) sweepOk = MatchesPairwise(subject, clip, crossings, pieces) && sweepOk;
+    }
+    return checksums[2] == checksums[0] && sweepOk ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+// 图形句柄基准：用 ShapeStore 所用的槽位表和按类型分池的连续数组存放随机对象，
+// 按 ShapeStore 的方式依次删除（池尾填补空位）、替换和清空后重新加入，
+// 确认之前取得的句柄全部失效、存活句柄仍解析到原对象，并报告按句柄访问的耗时
+// 用法：HandleBench [对象数 访问轮数]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "SlotTable.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+struct Item {
+    int id;
+};
+
+// 与 ShapeStore 相同的簿记：两种类型各一个池，另有绘制顺序表
+struct Store {
+    SlotTable<int> slots;
+    ShapePool<Item> pools[2];
+    std::vector<uint32_t> order;
+
+    const Item* Get(ShapeHandle handle) const {
+        if (!slots.IsValid(handle)) return nullptr;
+        const auto& s = slots[handle.slot];
+        return &pools[s.type].items[s.index];
+    }
+
+    ShapeHandle Add(int id) {
+        uint32_t slot = slots.Allocate();
+        Put(slot, id);
+        order.push_back(slot);
+        return slots.HandleOf(slot);
+    }
+
+    ShapeHandle Replace(size_t i, int id) {
+        Release(order[i]);
+        uint32_t slot = slots.Allocate();
+        Put(slot, id);
+        order[i] = slot;
+        return slots.HandleOf(slot);
+    }
+
+    void Erase(const std::vector<size_t>& positions) {
+        size_t next = 0, write = 0;
+        for (size_t read = 0; read < order.size(); read++) {
+            if (next < positions.size() && positions[next] == read) {
+                Release(order[read]);
+                next++;
+            } else {
+                order[write++] = order[read];
+            }
+        }
+        order.resize(write);
+    }
+
+    void Clear() {
+        slots.ReleaseAll();
+        order.clear();
+        pools[0].Clear();
+        pools[1].Clear();
+    }
+
+    void Put(uint32_t slot, int id) {
+        auto& s = slots[slot];
+        s.type = id & 1;
+        s.index = pools[s.type].Push(Item{ id }, slot);
+    }
+
+    void Release(uint32_t slot) {
+        auto& s = slots[slot];
+        uint32_t moved = pools[s.type].RemoveAt(s.index);
+        if (moved != ShapeHandle::INVALID_SLOT) {
+            slots[moved].index = s.index;
+        }
+        slots.Release(slot);
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 100;
+
+    std::mt19937 rng(7);
+    Store store;
+    std::vector<ShapeHandle> handles;
+    std::vector<int> ids;
+    int nextId = 0;
+    for (int i = 0; i < count; i++) {
+        ids.push_back(nextId);
+        handles.push_back(store.Add(nextId++));
+    }
+
+    size_t staleAccepted = 0, liveMismatched = 0;
+    auto checkLive = [&]() {
+        for (size_t i = 0; i < handles.size(); i++) {
+            const Item* item = store.Get(handles[i]);
+            if (!item || item->id != ids[i]) liveMismatched++;
+        }
+    };
+
+    // 删除约三分之一（池尾元素填补空位）
+    std::vector<size_t> positions;
+    std::vector<ShapeHandle> erased, survivors;
+    std::vector<int> survivorIds;
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (rng() % 3 == 0) {
+            positions.push_back(i);
+            erased.push_back(handles[i]);
+        } else {
+            survivors.push_back(handles[i]);
+            survivorIds.push_back(ids[i]);
+        }
+    }
+    store.Erase(positions);
+    handles.swap(survivors);
+    ids.swap(survivorIds);
+    for (const auto& h : erased) staleAccepted += store.Get(h) != nullptr;
+    checkLive();
+
+    // 替换：新图形复用刚释放的槽位
+    std::vector<ShapeHandle> replaced;
+    for (size_t i = 0; i < handles.size(); i += 7) {
+        replaced.push_back(handles[i]);
+        ids[i] = nextId;
+        handles[i] = store.Replace(i, nextId++);
+    }
+    for (const auto& h : replaced) staleAccepted += store.Get(h) != nullptr;
+    checkLive();
+
+    // 按句柄访问的耗时
+    Timer timer;
+    long long sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& h : handles) sum += store.Get(h)->id;
+    }
+    double ms = timer.ElapsedMs();
+
+    // 清空后加入同样多的对象，槽位全部被复用
+    std::vector<ShapeHandle> cleared = handles;
+    store.Clear();
+    handles.clear();
+    ids.clear();
+    for (size_t i = 0; i < cleared.size() + erased.size(); i++) {
+        ids.push_back(nextId);
+        handles.push_back(store.Add(nextId++));
+    }
+    for (const auto& h : cleared) staleAccepted += store.Get(h) != nullptr;
+    for (const auto& h : erased) staleAccepted += store.Get(h) != nullptr;
+    checkLive();
+
+    size_t stale = erased.size() + replaced.size() + cleared.size() + erased.size();
+    printf("%d x %zu handle lookups %9.2f ms  (checksum %lld)\n", rounds, cleared.size(), ms, sum);
+    printf("stale handles %zu  accepted %zu  live mismatches %zu  %s\n", stale, staleAccepted, liveMismatched,
+           staleAccepted == 0 && liveMismatched == 0 ? "OK" : "FAILED");
+    return staleAccepted == 0 && liveMismatched == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+// 选择（命中测试前的候选查找）基准：随机图形包围盒登记到空间索引，
+// 对随机点查询，与从后往前的线性扫描比较耗时并确认候选完全一致
+// 用法：PickBench [图形数 查询数]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "SpatialGrid.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int queries = argc > 2 ? atoi(argv[2]) : 10000;
+    const int width = 4000, height = 3000, margin = 10;
+
+    // 大多数是小图形，少数是跨越大半画布的大图形
+    std::mt19937 rng(12345);
+    std::vector<Rect> bounds(count);
+    for (auto& b : bounds) {
+        int x = rng() % width, y = rng() % height;
+        int size = (rng() % 100 == 0) ? 500 + rng() % 2000 : 4 + rng() % 60;
+        b = Rect(x, y, x + size, y + (int)(rng() % (size + 1)));
+    }
+
+    Timer buildTimer;
+    SpatialGrid grid;
+    for (int i = 0; i < count; i++) {
+        grid.Insert(i, bounds[i]);
+    }
+    double buildMs = buildTimer.ElapsedMs();
+
+    std::vector<Rect> areas(queries);
+    for (auto& a : areas) {
+        Point p(rng() % width, rng() % height);
+        a = Rect(p, p).Inflate(margin);
+    }
+
+    // 线性扫描：与原来的从后往前遍历相同
+    std::vector<std::vector<int>> expected(queries);
+    Timer linearTimer;
+    for (int q = 0; q < queries; q++) {
+        for (int i = count - 1; i >= 0; i--) {
+            if (bounds[i].Intersects(areas[q])) expected[q].push_back(i);
+        }
+    }
+    double linearMs = linearTimer.ElapsedMs();
+
+    std::vector<int> found;
+    size_t mismatches = 0, candidates = 0;
+    Timer gridTimer;
+    for (int q = 0; q < queries; q++) {
+        grid.Query(areas[q], found);
+        candidates += found.size();
+        if (found != expected[q]) mismatches++;
+    }
+    double gridMs = gridTimer.ElapsedMs();
+
+    printf("shapes=%d queries=%d build=%.2f ms\n", count, queries, buildMs);
+    printf("linear: %.4f ms/query\n", linearMs / queries);
+    printf("grid:   %.4f ms/query (avg %.1f candidates)\n", gridMs / queries, (double)candidates / queries);
+    printf("%s\n", mismatches == 0 ? "IDENTICAL" : "MISMATCH");
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+// 无窗口光栅化基准：在内存表面上绘制随机场景，统计各算法耗时
+// 用法：RasterBench [宽度 高度 图形数]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "DrawingAlgorithm.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// 表面内容的简单校验和，用于确认不同构建的输出一致
+uint64_t Checksum(const RasterTarget& target) {
+    uint64_t hash = 1469598103934665603ull;
+    for (int y = 0; y < target.Height(); y++) {
+        const uint32_t* row = target.Row(y);
+        for (int x = 0; x < target.Width(); x++) {
+            hash = (hash ^ row[x]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+void Report(const char* name, int count, double ms, const RasterTarget& target) {
+    printf("%-24s %8d items %10.2f ms  checksum %016llx\n",
+           name, count, ms, (unsigned long long)Checksum(target));
+}
+
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? atoi(argv[1]) : 1920;
+    int height = argc > 2 ? atoi(argv[2]) : 1080;
+    int count = argc > 3 ? atoi(argv[3]) : 20000;
+
+    RasterTarget target(width, height);
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> xs(-width / 4, width + width / 4);
+    std::uniform_int_distribution<int> ys(-height / 4, height + height / 4);
+    std::uniform_int_distribution<int> radii(1, 200);
+
+    std::vector<Point> lineEnds;
+    for (int i = 0; i < count * 2; i++) {
+        lineEnds.push_back(Point(xs(rng), ys(rng)));
+    }
+
+    const LineAlgorithm lineAlgos[] = { LineAlgorithm::Midpoint, LineAlgorithm::Bresenham, LineAlgorithm::RunSlice };
+    const char* lineNames[] = { "line/midpoint", "line/bresenham", "line/runslice" };
+    for (int a = 0; a < 3; a++) {
+        target.Clear(0xFFFFFF);
+        Timer timer;
+        for (int i = 0; i < count; i++) {
+            const Point& p1 = lineEnds[2 * i];
+            const Point& p2 = lineEnds[2 * i + 1];
+            DrawingAlgorithm::DrawLine(target, p1.x, p1.y, p2.x, p2.y, lineAlgos[a], RGB(0, 0, 255));
+        }
+        Report(lineNames[a], count, timer.ElapsedMs(), target);
+    }
+
+    // 接近水平/竖直的直线（折线密集的场景），游程较长
+    std::vector<Point> axisEnds;
+    std::mt19937 axisRng(999);
+    std::uniform_int_distribution<int> inX(0, width - 1), inY(0, height - 1);
+    for (int i = 0; i < count; i++) {
+        Point p1(inX(axisRng), inY(axisRng));
+        Point p2(inX(axisRng), inY(axisRng));
+        if (i % 2 == 0) {
+            p2.y = std::min(height - 1, std::max(0, p1.y + (p2.y - p1.y) / 16));
+        } else {
+            p2.x = std::min(width - 1, std::max(0, p1.x + (p2.x - p1.x) / 16));
+        }
+        axisEnds.push_back(p1);
+        axisEnds.push_back(p2);
+    }
+    const char* axisNames[] = { "axis-line/midpoint", "axis-line/bresenham", "axis-line/runslice" };
+    for (int a = 0; a < 3; a++) {
+        target.Clear(0xFFFFFF);
+        Timer timer;
+        for (int i = 0; i < count; i++) {
+            const Point& p1 = axisEnds[2 * i];
+            const Point& p2 = axisEnds[2 * i + 1];
+            DrawingAlgorithm::DrawLine(target, p1.x, p1.y, p2.x, p2.y, lineAlgos[a], RGB(0, 0, 255));
+        }
+        Report(axisNames[a], count, timer.ElapsedMs(), target);
+    }
+
+    const CircleAlgorithm circleAlgos[] = { CircleAlgorithm::Midpoint, CircleAlgorithm::Bresenham };
+    const char* circleNames[] = { "circle/midpoint", "circle/bresenham" };
+    for (int a = 0; a < 2; a++) {
+        target.Clear(0xFFFFFF);
+        std::mt19937 circleRng(777);
+        Timer timer;
+        for (int i = 0; i < count; i++) {
+            int cx = xs(circleRng), cy = ys(circleRng), r = radii(circleRng);
+            DrawingAlgorithm::DrawCircle(target, cx, cy, r, circleAlgos[a], RGB(255, 0, 0));
+        }
+        Report(circleNames[a], count, timer.ElapsedMs(), target);
+    }
+
+    // 放大后的场景：坐标绕中心放大 20 倍，绝大部分几何落在表面之外
+    int zoomCount = count / 20 > 0 ? count / 20 : 1;
+    const char* zoomLineNames[] = { "zoom-line/midpoint", "zoom-line/bresenham", "zoom-line/runslice" };
+    for (int a = 0; a < 3; a++) {
+        target.Clear(0xFFFFFF);
+        Timer timer;
+        for (int i = 0; i < zoomCount; i++) {
+            const Point& p1 = lineEnds[2 * i];
+            const Point& p2 = lineEnds[2 * i + 1];
+            DrawingAlgorithm::DrawLine(target, (p1.x - width / 2) * 20 + width / 2, (p1.y - height / 2) * 20 + height / 2,
+                                       (p2.x - width / 2) * 20 + width / 2, (p2.y - height / 2) * 20 + height / 2, lineAlgos[a], RGB(0, 0, 255));
+        }
+        Report(zoomLineNames[a], zoomCount, timer.ElapsedMs(), target);
+    }
+    const char* zoomCircleNames[] = { "zoom-circle/midpoint", "zoom-circle/bresenham" };
+    for (int a = 0; a < 2; a++) {
+        target.Clear(0xFFFFFF);
+        std::mt19937 circleRng(777);
+        Timer timer;
+        for (int i = 0; i < zoomCount; i++) {
+            int cx = xs(circleRng), cy = ys(circleRng), r = radii(circleRng);
+            DrawingAlgorithm::DrawCircle(target, (cx - width / 2) * 20 + width / 2, (cy - height / 2) * 20 + height / 2, r * 20,
+                                         circleAlgos[a], RGB(255, 0, 0));
+        }
+        Report(zoomCircleNames[a], zoomCount, timer.ElapsedMs(), target);
+    }
+
+    // 填充：多边形化的圆（与画布填充圆时的顶点数相同）
+    int fillCount = count / 20 > 0 ? count / 20 : 1;
+    std::vector<std::vector<Point>> polygons;
+    std::mt19937 fillRng(4242);
+    for (int i = 0; i < fillCount; i++) {
+        int cx = xs(fillRng), cy = ys(fillRng), r = radii(fillRng);
+        std::vector<Point> poly;
+        for (int k = 0; k < 60; k++) {
+            double angle = 2.0 * 3.14159265359 * k / 60;
+            poly.push_back(Point(cx + (int)(r * cos(angle)), cy + (int)(r * sin(angle))));
+        }
+        polygons.push_back(poly);
+    }
+
+    const FillAlgorithm fillAlgos[] = { FillAlgorithm::ScanLine, FillAlgorithm::Fence };
+    const char* fillNames[] = { "fill/scanline", "fill/fence" };
+    for (int a = 0; a < 2; a++) {
+        target.Clear(0xFFFFFF);
+        Timer timer;
+        for (const auto& poly : polygons) {
+            DrawingAlgorithm::FillPolygon(target, poly, fillAlgos[a], RGB(135, 206, 250));
+        }
+        Report(fillNames[a], fillCount, timer.ElapsedMs(), target);
+    }
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+// 水平像素段写入的微基准：比较标量 / SSE2 / AVX2 实现在不同长度区间上的吞吐量
+// 用法：SpanBench [每种配置写入的总像素数（百万）]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "SpanWriter.h"
+
+namespace {
+
+const int SURFACE_WIDTH = 4096;
+const int SURFACE_ROWS = 64;
+
+double Run(int spanLength, long long totalPixels, bool blend) {
+    std::vector<uint32_t> surface((size_t)SURFACE_WIDTH * SURFACE_ROWS, 0x00FFFFFF);
+    long long spans = totalPixels / spanLength;
+    int perRow = SURFACE_WIDTH / spanLength;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < spans; i++) {
+        // 区间在表面上轮转，起点故意不对齐
+        int row = (int)((i / perRow) % SURFACE_ROWS);
+        int col = (int)(i % perRow) * spanLength;
+        int offset = (int)(i & 3);
+        if (col + offset + spanLength > SURFACE_WIDTH) offset = 0;
+        uint32_t* dst = surface.data() + (size_t)row * SURFACE_WIDTH + col + offset;
+        if (blend) {
+            SpanWriter::Blend(dst, spanLength, 0x0087CEFA, 128);
+        } else {
+            SpanWriter::Fill(dst, spanLength, 0x0087CEFA + (uint32_t)(i & 1));
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 防止编译器把写入优化掉
+    volatile uint32_t sink = surface[(size_t)SURFACE_WIDTH * SURFACE_ROWS / 2];
+    (void)sink;
+    return spans * (double)spanLength / seconds / 1e9;
+}
+
+// 各实现的混合结果必须逐位一致
+bool CheckBlendConsistency() {
+    std::vector<uint32_t> reference(257), candidate(257);
+    for (int alpha = 1; alpha < 255; alpha += 7) {
+        for (size_t i = 0; i < reference.size(); i++) {
+            reference[i] = candidate[i] = (uint32_t)(i * 2654435761u) & 0x00FFFFFF;
+        }
+        SpanKernel saved = SpanWriter::GetKernel();
+        SpanWriter::SetKernel(SpanKernel::Scalar);
+        SpanWriter::Blend(reference.data(), (int)reference.size(), 0x00123456, (uint8_t)alpha);
+        SpanWriter::SetKernel(saved);
+        SpanWriter::Blend(candidate.data(), (int)candidate.size(), 0x00123456, (uint8_t)alpha);
+        if (reference != candidate) return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    long long totalPixels = (argc > 1 ? atoll(argv[1]) : 200) * 1000000LL;
+
+    const SpanKernel kernels[] = { SpanKernel::Scalar, SpanKernel::SSE2, SpanKernel::AVX2 };
+    const int lengths[] = { 8, 64, 1024 };
+    const char* lengthNames[] = { "short(8)", "medium(64)", "long(1024)" };
+
+    printf("%-8s %-6s %14s %14s %14s\n", "kernel", "op", lengthNames[0], lengthNames[1], lengthNames[2]);
+    for (SpanKernel kernel : kernels) {
+        if (!SpanWriter::SetKernel(kernel)) {
+            printf("%-8s (not supported on this CPU)\n", SpanWriter::GetKernelName(kernel));
+            continue;
+        }
+        if (!CheckBlendConsistency()) {
+            printf("%-8s blend output differs from scalar!\n", SpanWriter::GetKernelName(kernel));
+            return 1;
+        }
+        for (int blend = 0; blend < 2; blend++) {
+            printf("%-8s %-6s", SpanWriter::GetKernelName(kernel), blend ? "blend" : "fill");
+            for (int length : lengths) {
+                printf(" %9.2f Gpx/s", Run(length, totalPixels, blend != 0));
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
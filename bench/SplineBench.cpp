@@ -0,0 +1,208 @@
+// B 样条细分基准：同一组控制点分别逐点计算基函数和用前向差分细分，
+// 比较耗时并确认两者的采样点相差不超过 1 像素；
+// 再按平直度容差自适应细分，统计生成的点数和折线与曲线的最大偏差；
+// 最后用通用的 NURBS（de Boor）批量求值计算同样的采样点，确认与三次专用路径一致且不慢于逐点计算基函数，
+// 并确认各次数的有理曲线批量求值与逐点求值一致；
+// 逐个增加控制点时原地追加的曲线与每次整体重建的曲线细分结果相同（均匀节点的二次有理曲线）
+// 用法：SplineBench [控制点数 每段细分数 重复次数 平直度容差]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "NurbsCurve.h"
+#include "SplineTessellator.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// 细分整条曲线（每 4 个连续控制点一段）
+template <typename SegmentFunc>
+void Tessellate(const std::vector<Point>& controlPoints, int steps, std::vector<Point>& out, SegmentFunc segment) {
+    out.clear();
+    for (size_t i = 0; i + 3 < controlPoints.size(); i++) {
+        segment(&controlPoints[i], steps, out);
+    }
+}
+
+// 曲线上 t 处的精确点（不取整）
+void EvaluateExact(const Point* cp, double t, double& x, double& y) {
+    double f1 = (1 - t) * (1 - t) * (1 - t) / 6.0;
+    double f2 = (3 * t * t * t - 6 * t * t + 4) / 6.0;
+    double f3 = (-3 * t * t * t + 3 * t * t + 3 * t + 1) / 6.0;
+    double f4 = t * t * t / 6.0;
+    x = f1 * cp[0].x + f2 * cp[1].x + f3 * cp[2].x + f4 * cp[3].x;
+    y = f1 * cp[0].y + f2 * cp[1].y + f3 * cp[2].y + f4 * cp[3].y;
+}
+
+// 点到线段的距离
+double DistanceToSegment(double px, double py, const Point& a, const Point& b) {
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double len2 = dx * dx + dy * dy;
+    double t = len2 > 0 ? std::max(0.0, std::min(1.0, ((px - a.x) * dx + (py - a.y) * dy) / len2)) : 0.0;
+    double ex = a.x + t * dx - px, ey = a.y + t * dy - py;
+    return sqrt(ex * ex + ey * ey);
+}
+
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 50000;
+    int steps = argc > 2 ? atoi(argv[2]) : 20;
+    int repeat = argc > 3 ? atoi(argv[3]) : 20;
+    double tolerance = argc > 4 ? atof(argv[4]) : 0.5;
+
+    // 随机游走的控制点，模拟手绘的长曲线
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> step(-40, 40);
+    std::vector<Point> controlPoints;
+    Point p(2000, 2000);
+    for (int i = 0; i < count; i++) {
+        p = Point(p.x + step(rng), p.y + step(rng));
+        controlPoints.push_back(p);
+    }
+
+    std::vector<Point> direct, forward;
+    Timer directTimer;
+    for (int r = 0; r < repeat; r++) Tessellate(controlPoints, steps, direct, SplineTessellator::TessellateCubicDirect);
+    double directMs = directTimer.ElapsedMs();
+
+    Timer forwardTimer;
+    for (int r = 0; r < repeat; r++) Tessellate(controlPoints, steps, forward, SplineTessellator::TessellateCubic);
+    double forwardMs = forwardTimer.ElapsedMs();
+
+    int maxError = 0;
+    size_t differing = 0;
+    for (size_t i = 0; i < direct.size(); i++) {
+        int ex = abs(direct[i].x - forward[i].x);
+        int ey = abs(direct[i].y - forward[i].y);
+        if (ex || ey) differing++;
+        if (ex > maxError) maxError = ex;
+        if (ey > maxError) maxError = ey;
+    }
+    bool ok = direct.size() == forward.size() && maxError <= 1;
+    printf("%zu samples  direct %8.2f ms  forward-difference %8.2f ms  speedup %.2fx\n",
+           direct.size(), directMs, forwardMs, directMs / forwardMs);
+    printf("max error %d px, %zu samples differ%s\n", maxError, differing, ok ? "" : "  MISMATCH");
+
+    // 自适应细分：每段的等分数由容差决定，在每个小区间内取若干参数检查曲线到对应弦的距离
+    std::vector<Point> adaptive;
+    Timer adaptiveTimer;
+    for (int r = 0; r < repeat; r++) {
+        Tessellate(controlPoints, steps, adaptive, [&](const Point* cp, int, std::vector<Point>& out) {
+            SplineTessellator::TessellateCubicAdaptive(cp, tolerance, out);
+        });
+    }
+    double adaptiveMs = adaptiveTimer.ElapsedMs();
+
+    double maxDeviation = 0.0;
+    for (size_t i = 0; i + 3 < controlPoints.size(); i++) {
+        const Point* cp = &controlPoints[i];
+        int n = SplineTessellator::StepsForTolerance(cp, tolerance);
+        std::vector<Point> segment;
+        SplineTessellator::TessellateCubic(cp, n, segment);
+        for (int j = 0; j < n; j++) {
+            for (int k = 1; k < 4; k++) {
+                double x, y;
+                EvaluateExact(cp, (j + k / 4.0) / n, x, y);
+                maxDeviation = std::max(maxDeviation, DistanceToSegment(x, y, segment[j], segment[j + 1]));
+            }
+        }
+    }
+    printf("adaptive (tolerance %.2f px): %zu samples (%.1f%% of fixed)  %8.2f ms  max deviation %.2f px\n",
+           tolerance, adaptive.size(), 100.0 * adaptive.size() / direct.size(), adaptiveMs, maxDeviation);
+
+    // 均匀节点、权重全为 1 的三次 NURBS 与三次均匀 B 样条相同：第 i 段的参数为 i + j / steps
+    NurbsCurve nurbs;
+    std::vector<double> knots;
+    NurbsCurve::UniformKnots(3, controlPoints.size(), knots);
+    nurbs.Set(3, controlPoints, knots, std::vector<double>());
+    std::vector<double> params;
+    for (size_t i = 0; i < nurbs.SpanCount(); i++) {
+        for (int j = 0; j <= steps; j++) params.push_back(nurbs.SpanStart(i) + (double)j / steps);
+    }
+    std::vector<Point> deBoor;
+    Timer deBoorTimer;
+    for (int r = 0; r < repeat; r++) {
+        deBoor.clear();
+        nurbs.Evaluate(params.data(), params.size(), deBoor);
+    }
+    double deBoorMs = deBoorTimer.ElapsedMs();
+    int nurbsError = 0;
+    for (size_t i = 0; i < deBoor.size() && i < forward.size(); i++) {
+        nurbsError = std::max(nurbsError, std::max(abs(deBoor[i].x - forward[i].x), abs(deBoor[i].y - forward[i].y)));
+    }
+    bool nurbsOk = deBoor.size() == forward.size() && nurbsError <= 1;
+    printf("de Boor batch: %zu samples  %8.2f ms  (%.2fx direct)  max error vs forward difference %d px%s\n",
+           deBoor.size(), deBoorMs, directMs / deBoorMs, nurbsError, nurbsOk ? "" : "  MISMATCH");
+    ok = ok && nurbsOk;
+
+    // 有理曲线（随机权重、两端重复节点）：批量求值与逐点求值相差不超过 1 像素
+    std::uniform_real_distribution<double> weight(0.25, 4.0);
+    std::vector<Point> rationalPoints(controlPoints.begin(), controlPoints.begin() + std::min<size_t>(2000, controlPoints.size()));
+    std::vector<double> weights;
+    for (size_t i = 0; i < rationalPoints.size(); i++) weights.push_back(weight(rng));
+    for (int degree = 1; degree <= 7; degree++) {
+        NurbsCurve::ClampedKnots(degree, rationalPoints.size(), knots);
+        if (!nurbs.Set(degree, rationalPoints, knots, weights)) continue;
+        params.clear();
+        for (size_t i = 0; i < nurbs.SpanCount(); i++) {
+            for (int j = 0; j < steps; j++) params.push_back(nurbs.SpanStart(i) + (double)j / steps);
+        }
+        std::vector<Point> batch;
+        nurbs.Evaluate(params.data(), params.size(), batch);
+        int rationalError = 0;
+        for (size_t i = 0; i < params.size(); i++) {
+            Point single = nurbs.Evaluate(params[i]);
+            rationalError = std::max(rationalError, std::max(abs(single.x - batch[i].x), abs(single.y - batch[i].y)));
+        }
+        if (rationalError > 1) {
+            printf("rational degree %d: batch vs single max error %d px  MISMATCH\n", degree, rationalError);
+            ok = false;
+        }
+    }
+
+    // 逐个增加控制点：每次只细分新出现的一段
+    size_t growCount = std::min<size_t>(5000, controlPoints.size());
+    weights.clear();
+    for (size_t i = 0; i < growCount; i++) weights.push_back(weight(rng));
+    std::vector<Point> appended, rebuilt;
+    NurbsCurve growing;
+    Timer appendTimer;
+    for (size_t n = 3; n <= growCount; n++) {
+        if (n == 3) {
+            std::vector<Point> head(controlPoints.begin(), controlPoints.begin() + 3);
+            NurbsCurve::UniformKnots(2, 3, knots);
+            growing.Set(2, head, knots, std::vector<double>(weights.begin(), weights.begin() + 3));
+        } else {
+            growing.Append(controlPoints[n - 1], weights[n - 1], growing.LastKnot() + 1.0);
+        }
+        if (!appended.empty()) appended.pop_back();
+        growing.TessellateSpan(growing.SpanCount() - 1, tolerance, appended);
+    }
+    double appendMs = appendTimer.ElapsedMs();
+
+    Timer rebuildTimer;
+    for (size_t n = 3; n <= growCount; n++) {
+        std::vector<Point> head(controlPoints.begin(), controlPoints.begin() + n);
+        NurbsCurve::UniformKnots(2, n, knots);
+        nurbs.Set(2, head, knots, std::vector<double>(weights.begin(), weights.begin() + n));
+        if (!rebuilt.empty()) rebuilt.pop_back();
+        nurbs.TessellateSpan(nurbs.SpanCount() - 1, tolerance, rebuilt);
+    }
+    double rebuildMs = rebuildTimer.ElapsedMs();
+    bool growOk = appended == rebuilt;
+    printf("grow to %zu points: append %8.2f ms  rebuild %8.2f ms  %s\n",
+           growCount, appendMs, rebuildMs, growOk ? "identical" : "MISMATCH");
+    ok = ok && growOk;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+// 分块并行光栅化基准：同一场景分别串行绘制和用不同线程数分块绘制，
+// 比较耗时并确认输出逐位一致
+// 用法：TileBench [宽度 高度 图形数 最大线程数]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "DrawingAlgorithm.h"
+#include "TileRenderer.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+uint64_t Checksum(const RasterTarget& target) {
+    uint64_t hash = 1469598103934665603ull;
+    for (int y = 0; y < target.Height(); y++) {
+        const uint32_t* row = target.Row(y);
+        for (int x = 0; x < target.Width(); x++) {
+            hash = (hash ^ row[x]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// 场景中的图元：直线、圆或填充多边形
+struct Item {
+    int kind;
+    int algorithm;
+    COLORREF color;
+    std::vector<Point> points;   // 直线两端点 / 圆心和 (半径, 0) / 多边形顶点
+    Rect bounds;
+};
+
+void DrawItem(const Item& item, RasterTarget& target) {
+    const auto& p = item.points;
+    switch (item.kind) {
+    case 0:
+        DrawingAlgorithm::DrawLine(target, p[0].x, p[0].y, p[1].x, p[1].y, (LineAlgorithm)item.algorithm, item.color);
+        break;
+    case 1:
+        DrawingAlgorithm::DrawCircle(target, p[0].x, p[0].y, p[1].x, (CircleAlgorithm)item.algorithm, item.color);
+        break;
+    default:
+        DrawingAlgorithm::FillPolygon(target, p, (FillAlgorithm)item.algorithm, item.color);
+        break;
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? atoi(argv[1]) : 1920;
+    int height = argc > 2 ? atoi(argv[2]) : 1080;
+    int count = argc > 3 ? atoi(argv[3]) : 20000;
+
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> xs(0, width - 1), ys(0, height - 1);
+    std::uniform_int_distribution<int> sizes(2, 150);
+    std::vector<Item> items;
+    for (int i = 0; i < count; i++) {
+        Item item;
+        item.kind = i % 10 == 0 ? 2 : (i % 3 == 0 ? 1 : 0);
+        item.color = RGB(rng() % 256, rng() % 256, rng() % 256);
+        int cx = xs(rng), cy = ys(rng), size = sizes(rng);
+        if (item.kind == 0) {
+            item.algorithm = 1 + (int)(rng() % 3);   // 中点法 / Bresenham / 游程切片
+            item.points = { Point(cx, cy), Point(cx + (int)(rng() % (2 * size)) - size, cy + (int)(rng() % (2 * size)) - size) };
+            item.bounds = Rect(item.points[0], item.points[1]);
+        } else if (item.kind == 1) {
+            item.algorithm = 1 + (int)(rng() % 2);
+            item.points = { Point(cx, cy), Point(size, 0) };
+            item.bounds = Rect(cx - size, cy - size, cx + size, cy + size);
+        } else {
+            item.algorithm = (int)(rng() % 2);
+            int n = 3 + (int)(rng() % 8);
+            for (int k = 0; k < n; k++) {
+                item.points.push_back(Point(cx + (int)(rng() % (2 * size)) - size, cy + (int)(rng() % (2 * size)) - size));
+            }
+            item.bounds = DrawingAlgorithm::GetPolygonBounds(item.points);
+        }
+        items.push_back(item);
+    }
+    std::vector<Rect> bounds;
+    for (const auto& item : items) bounds.push_back(item.bounds);
+
+    RasterTarget surface(width, height);
+
+    // 串行基准
+    surface.Clear(0xFFFFFF);
+    Timer serialTimer;
+    for (const auto& item : items) DrawItem(item, surface);
+    double serialMs = serialTimer.ElapsedMs();
+    uint64_t reference = Checksum(surface);
+    printf("%-12s %10.2f ms  checksum %016llx\n", "serial", serialMs, (unsigned long long)reference);
+
+    int maxThreads = argc > 4 ? atoi(argv[4]) : (int)std::thread::hardware_concurrency();
+    if (maxThreads < 1) maxThreads = 1;
+    bool ok = true;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        WorkerPool pool(threads);
+        TileRenderer renderer(&pool);
+        renderer.SetMinParallelItems(0);
+
+        surface.Clear(0xFFFFFF);
+        Timer timer;
+        renderer.Render(surface, bounds, [&](size_t index, RasterTarget& tile) { DrawItem(items[index], tile); });
+        double ms = timer.ElapsedMs();
+        uint64_t sum = Checksum(surface);
+        printf("tiled x%-4d %10.2f ms  checksum %016llx  speedup %.2fx%s\n",
+               threads, ms, (unsigned long long)sum, serialMs / ms, sum == reference ? "" : "  MISMATCH");
+        ok = ok && sum == reference;
+        if (threads * 2 > maxThreads && threads != maxThreads) threads = maxThreads / 2;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// 批量顶点变换基准：对同一组顶点分别用逐点的 Point::Translate / Scale / Rotate、
+// 图形实际使用的 AffineTransform::Map（x86 上为 SSE2）和它的标量实现 MapScalar 做变换，比较耗时；
+// Map 与 MapScalar 必须逐位一致（含原地映射和奇数个顶点的尾部），逐点路径向零截断，与 Map 相差不超过 1
+// 用法：TransformBench [顶点数 重复次数]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "AffineTransform.h"
+
+namespace {
+
+struct Timer {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double ElapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// 一种变换：逐点实现和对应的（相对中心点的）矩阵
+struct Case {
+    const char* name;
+    Point (*perPoint)(const Point& p, const Point& center);
+    AffineMatrix matrix;
+};
+
+const double ANGLE = 0.3;
+
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 50001;
+    int repeat = argc > 2 ? atoi(argv[2]) : 200;
+
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> coords(-4000, 4000);
+    std::vector<Point> source(count);
+    for (auto& p : source) p = Point(coords(rng), coords(rng));
+    const Point center(640, 360);
+
+    // half 的结果大量落在 .5 上，检查两种实现的就近取偶一致
+    const Case cases[] = {
+        { "translate", [](const Point& p, const Point&) { return p.Translate(7, -3); }, AffineMatrix::Translation(7, -3) },
+        { "scale", [](const Point& p, const Point& c) { return p.Scale(1.1, 0.9, c); }, AffineMatrix::Scaling(1.1, 0.9) },
+        { "half", [](const Point& p, const Point& c) { return p.Scale(0.5, 0.5, c); }, AffineMatrix::Scaling(0.5, 0.5) },
+        { "rotate", [](const Point& p, const Point& c) { return p.Rotate(ANGLE, c); }, AffineMatrix::Rotation(ANGLE) },
+    };
+
+    bool ok = true;
+    for (const auto& c : cases) {
+        AffineMatrix m = AffineMatrix::About(c.matrix, center);
+
+        // 逐点路径（旋转每个点都重新计算三角函数）
+        std::vector<Point> reference = source;
+        Timer pointTimer;
+        for (int r = 0; r < repeat; r++) {
+            for (size_t i = 0; i < source.size(); i++) reference[i] = c.perPoint(source[i], center);
+        }
+        double pointMs = pointTimer.ElapsedMs();
+
+        std::vector<Point> scalar(source.size());
+        Timer scalarTimer;
+        for (int r = 0; r < repeat; r++) {
+            AffineTransform::MapScalar(source.data(), scalar.data(), source.size(), m);
+        }
+        double scalarMs = scalarTimer.ElapsedMs();
+
+        std::vector<Point> batch;
+        Timer batchTimer;
+        for (int r = 0; r < repeat; r++) {
+            AffineTransform::Map(source, batch, m);
+        }
+        double batchMs = batchTimer.ElapsedMs();
+
+        std::vector<Point> inPlace = source;
+        AffineTransform::Map(inPlace.data(), inPlace.data(), inPlace.size(), m);
+
+        int maxDiff = 0;
+        for (size_t i = 0; i < source.size(); i++) {
+            maxDiff = std::max(maxDiff, std::max(abs(reference[i].x - batch[i].x), abs(reference[i].y - batch[i].y)));
+        }
+        bool same = batch == scalar && inPlace == scalar && maxDiff <= 1;
+        printf("%-10s per-point %8.2f ms  scalar %8.2f ms  map %8.2f ms  speedup %.2fx  per-point diff %d%s\n",
+               c.name, pointMs, scalarMs, batchMs, pointMs / batchMs, maxDiff, same ? "" : "  MISMATCH");
+        ok = ok && same;
+    }
+    return ok ? 0 : 1;
+}
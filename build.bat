@@ -18,7 +18,7 @@ echo Compiling...
 echo(
 
 g++ -std=c++17 -DUNICODE -D_UNICODE -Isrc ^
-    src/MainWindow.cpp src/Shape.cpp src/Canvas.cpp src/DrawingAlgorithm.cpp src/WeilerAtherton.cpp ^
+    src/MainWindow.cpp src/Shape.cpp src/Canvas.cpp src/DrawingAlgorithm.cpp src/WeilerAtherton.cpp src/RasterTarget.cpp src/EdgeTable.cpp src/FenceMask.cpp src/SpanWriter.cpp src/WorkerPool.cpp src/TileRenderer.cpp src/SceneCache.cpp src/DamageRegion.cpp src/SpatialGrid.cpp src/ShapeStore.cpp src/AffineTransform.cpp src/SplineTessellator.cpp src/NurbsCurve.cpp src/PolygonBoolean.cpp ^
     -o build/GraphicsApp.exe ^
     -luser32 -lgdi32 -lcomctl32 -mwindows -static
 
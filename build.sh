@@ -0,0 +1,23 @@
+#!/bin/sh
+# 无窗口（Linux 等）构建：编译可移植的光栅化/裁剪核心以及 bench 目录下的基准程序
+set -e
+
+# 切换到脚本所在目录，保证相对路径可靠
+cd "$(dirname "$0")"
+
+echo "===================================="
+echo "Headless g++ build"
+echo "===================================="
+
+mkdir -p build
+
+CORE="src/RasterTarget.cpp src/SpanWriter.cpp src/EdgeTable.cpp src/FenceMask.cpp src/DrawingAlgorithm.cpp src/WeilerAtherton.cpp src/WorkerPool.cpp src/TileRenderer.cpp src/DamageRegion.cpp src/SpatialGrid.cpp src/AffineTransform.cpp src/SplineTessellator.cpp src/NurbsCurve.cpp src/PolygonBoolean.cpp"
+
+for bench in bench/*.cpp; do
+    name=$(basename "$bench" .cpp)
+    echo "Compiling $name..."
+    g++ -std=c++17 -O2 -pthread -Isrc $CORE "$bench" -o "build/$name"
+done
+
+echo "Build SUCCESS"
+echo "Output: build/"
@@ -0,0 +1,77 @@
+#include "AffineTransform.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AFFINE_TRANSFORM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Point 是两个连续的 int，SSE2 路径按 int 数组读写
+static_assert(sizeof(Point) == 2 * sizeof(int), "Point must be two packed ints");
+
+// lrint 与 SSE2 的 cvtpd 一样按当前舍入模式（默认就近取偶）取整，两种实现结果一致
+void AffineTransform::MapScalar(const Point* src, Point* dst, size_t count, const AffineMatrix& m) {
+    for (size_t i = 0; i < count; i++) {
+        double x = src[i].x;
+        double y = src[i].y;
+        dst[i].x = (int)lrint(m.m00 * x + m.m01 * y + m.m02);
+        dst[i].y = (int)lrint(m.m10 * x + m.m11 * y + m.m12);
+    }
+}
+
+#ifdef AFFINE_TRANSFORM_SSE2
+
+// 整数平移：每次加 2 个顶点（4 个 int）
+static void TranslateSSE2(Point* points, size_t count, int dx, int dy) {
+    const __m128i offset = _mm_setr_epi32(dx, dy, dx, dy);
+    int* data = reinterpret_cast<int*>(points);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 2 * i), _mm_add_epi32(v, offset));
+    }
+    for (; i < count; i++) {
+        points[i].x += dx;
+        points[i].y += dy;
+    }
+}
+
+// 一般仿射变换：每次 2 个顶点，运算顺序与标量实现相同（先乘加两项，再加平移），cvtpd 按就近取偶取整
+static void MapSSE2(const Point* src, Point* dst, size_t count, const AffineMatrix& m) {
+    const __m128d col0 = _mm_setr_pd(m.m00, m.m10);
+    const __m128d col1 = _mm_setr_pd(m.m01, m.m11);
+    const __m128d col2 = _mm_setr_pd(m.m02, m.m12);
+    const int* in = reinterpret_cast<const int*>(src);
+    int* out = reinterpret_cast<int*>(dst);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        __m128d a = _mm_cvtepi32_pd(v);
+        __m128d b = _mm_cvtepi32_pd(_mm_srli_si128(v, 8));
+        __m128d ra = _mm_add_pd(_mm_add_pd(_mm_mul_pd(col0, _mm_unpacklo_pd(a, a)),
+                                           _mm_mul_pd(col1, _mm_unpackhi_pd(a, a))), col2);
+        __m128d rb = _mm_add_pd(_mm_add_pd(_mm_mul_pd(col0, _mm_unpacklo_pd(b, b)),
+                                           _mm_mul_pd(col1, _mm_unpackhi_pd(b, b))), col2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+                         _mm_unpacklo_epi64(_mm_cvtpd_epi32(ra), _mm_cvtpd_epi32(rb)));
+    }
+    AffineTransform::MapScalar(src + i, dst + i, count - i, m);
+}
+
+#endif
+
+void AffineTransform::Map(const Point* src, Point* dst, size_t count, const AffineMatrix& m) {
+#ifdef AFFINE_TRANSFORM_SSE2
+    if (m.IsIntegerTranslation()) {
+        // 整数平移不需要取整：先复制再整体加偏移
+        if (dst != src) {
+            for (size_t i = 0; i < count; i++) dst[i] = src[i];
+        }
+        TranslateSSE2(dst, count, (int)m.m02, (int)m.m12);
+    } else {
+        MapSSE2(src, dst, count, m);
+    }
+#else
+    MapScalar(src, dst, count, m);
+#endif
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Point.h"
+
+// 2×3 仿射矩阵。Translation / Scaling / Rotation 构造相对某个中心点（pivot）的变换，
+// 用 About 改写成绝对坐标下的矩阵后才交给 AffineTransform::Map
+struct AffineMatrix {
+    double m00, m01, m02;
+    double m10, m11, m12;
+
+    static AffineMatrix Identity() { return { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0 }; }
+    static AffineMatrix Translation(int dx, int dy) { return { 1.0, 0.0, (double)dx, 0.0, 1.0, (double)dy }; }
+    static AffineMatrix Scaling(double sx, double sy) { return { sx, 0.0, 0.0, 0.0, sy, 0.0 }; }
+    // 旋转（弧度）：三角函数只在这里计算一次
+    static AffineMatrix Rotation(double angleRad) {
+        double s = sin(angleRad);
+        double c = cos(angleRad);
+        return { c, -s, 0.0, s, c, 0.0 };
+    }
+
+    // 相对 pivot 的变换改写成绝对坐标下的矩阵：x' = m00 * x + m01 * y + m02（y 同理）
+    static AffineMatrix About(const AffineMatrix& m, const Point& pivot) {
+        return { m.m00, m.m01, m.m02 + pivot.x - m.m00 * pivot.x - m.m01 * pivot.y,
+                 m.m10, m.m11, m.m12 + pivot.y - m.m10 * pivot.x - m.m11 * pivot.y };
+    }
+    // 复合：先做 b 再做 a（均为绝对坐标下的矩阵）
+    static AffineMatrix Multiply(const AffineMatrix& a, const AffineMatrix& b) {
+        return { a.m00 * b.m00 + a.m01 * b.m10, a.m00 * b.m01 + a.m01 * b.m11, a.m00 * b.m02 + a.m01 * b.m12 + a.m02,
+                 a.m10 * b.m00 + a.m11 * b.m10, a.m10 * b.m01 + a.m11 * b.m11, a.m10 * b.m02 + a.m11 * b.m12 + a.m12 };
+    }
+
+    bool IsIdentity() const {
+        return m00 == 1.0 && m01 == 0.0 && m02 == 0.0 && m10 == 0.0 && m11 == 1.0 && m12 == 0.0;
+    }
+    // 是否只是整数平移（可以走纯整数加法的路径）
+    bool IsIntegerTranslation() const {
+        return m00 == 1.0 && m01 == 0.0 && m10 == 0.0 && m11 == 1.0 &&
+               m02 == (double)(int)m02 && m12 == (double)(int)m12;
+    }
+};
+
+// 批量顶点变换：对连续存放的顶点数组做同一个仿射变换
+// x86 上用 SSE2 每次处理两个顶点，其余平台走标量实现，两者输出逐位一致
+class AffineTransform {
+public:
+    // 把 src[0, count) 用绝对坐标矩阵 m 映射到 dst（可以与 src 相同），结果四舍五入到最近整数
+    // 用于从原始几何和累积矩阵一次算出设备坐标，多次变换不会累积取整误差
+    static void Map(const Point* src, Point* dst, size_t count, const AffineMatrix& m);
+    static void Map(const std::vector<Point>& src, std::vector<Point>& dst, const AffineMatrix& m) {
+        dst.resize(src.size());
+        Map(src.data(), dst.data(), src.size(), m);
+    }
+    // 标量实现（用于对比和基准测试）
+    static void MapScalar(const Point* src, Point* dst, size_t count, const AffineMatrix& m);
+};
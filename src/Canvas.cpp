@@ -7,13 +7,17 @@
 Canvas::Canvas() : currentMode(DrawMode::None), isDrawing(false), 
                    selectedShapeIndex(-1), isSelectMode(false), 
                    pendingFillAlgorithm(FillAlgorithm::ScanLine),
-                   hasClipRect(false), hasTransformAnchor(false), isDragging(false) {}
+                   hasClipRect(false), hasTransformAnchor(false), isDragging(false),
+                   pendingBooleanOp(BooleanOp::Intersection) {}
 
 void Canvas::SetDrawMode(DrawMode mode) {
     currentMode = mode;
     currentShape.reset();
     isDrawing = false;
     
+    // 放弃未完成的布尔运算选择
+    CancelBooleanPick();
+    
     // 只在切换到绘图模式时清理变换状态
     if (mode != DrawMode::Translate && mode != DrawMode::Scale && 
         mode != DrawMode::Rotate && mode != DrawMode::SetClipWindow) {
@@ -138,6 +142,31 @@ void Canvas::OnMouseLeftDown(int x, int y) {
         return;
     }
     
+    // 处理布尔运算模式：第一次点击选中第一个图形（保持高亮），第二次点击选中另一个图形并执行运算
+    if (currentMode == DrawMode::Boolean) {
+        SelectShapeAt(p);
+        int picked = selectedShapeIndex;
+        // 选择状态由 booleanFirst 记录（句柄在图形增删后仍能判断是否有效）
+        selectedShapeIndex = -1;
+        if (picked < 0) return;
+        if (!shapes[picked].GetOutline()) {
+            // 不能构成区域的图形（直线、未闭合的多段线等）不参与运算
+            DamageShape(shapes[picked]);
+            shapes[picked].SetSelected(false);
+            return;
+        }
+        ShapeHandle handle = shapes.HandleAt(picked);
+        if (!shapes.Get(booleanFirst)) {
+            // 尚未选择，或第一个图形已被其他操作删除：本次点击作为第一个图形
+            booleanFirst = handle;
+        } else if (handle.slot != booleanFirst.slot) {
+            ShapeHandle first = booleanFirst;
+            booleanFirst = ShapeHandle();
+            CombineShapes(first, handle, pendingBooleanOp);
+        }
+        return;
+    }
+    
     // 如果处于填充选择模式
     if (isSelectMode) {
         SelectShapeAtPoint(x, y);
@@ -161,8 +190,7 @@ void Canvas::OnMouseLeftDown(int x, int y) {
 
         // 检查图形是否完成
         if (currentShape->IsComplete()) {
-            shapes.push_back(currentShape);
-            currentShape.reset();
+            CommitShape(std::move(currentShape));
             isDrawing = false;
         }
     }
@@ -171,32 +199,42 @@ void Canvas::OnMouseLeftDown(int x, int y) {
 void Canvas::OnMouseRightDown(int x, int y) {
     if (!currentShape) return;
 
+    bool finished = false;
+    switch (currentShape->GetType()) {
     // 多段线:右键完成绘制
-    if (auto polyline = std::dynamic_pointer_cast<class Polyline>(currentShape)) {
-        if (polyline->GetPointCount() >= 2) {
-            polyline->Close();
-            shapes.push_back(currentShape);
-            currentShape.reset();
-            isDrawing = false;
+    case ShapeType::Polyline: {
+        auto& polyline = static_cast<class Polyline&>(*currentShape);
+        if (polyline.GetPointCount() >= 2) {
+            polyline.Close();
+            finished = true;
         }
+        break;
     }
     // B样条:右键完成绘制
-    else if (auto bspline = std::dynamic_pointer_cast<BSpline>(currentShape)) {
-        if (bspline->GetPointCount() >= 4) {  // 至少4个控制点才能绘制平滑曲线
-            bspline->Finish();
-            shapes.push_back(currentShape);
-            currentShape.reset();
-            isDrawing = false;
+    case ShapeType::BSpline: {
+        auto& bspline = static_cast<BSpline&>(*currentShape);
+        if (bspline.GetPointCount() >= (size_t)bspline.GetDegree() + 1) {  // 至少 degree + 1 个控制点（三次为4个）才能绘制平滑曲线
+            bspline.Finish();
+            finished = true;
         }
+        break;
     }
     // 实验二：多边形 - 右键完成绘制并闭合
-    else if (auto polygon = std::dynamic_pointer_cast<class Polygon>(currentShape)) {
-        if (polygon->GetVertexCount() >= 3) {  // 至少3个顶点才能形成多边形
-            polygon->Close();
-            shapes.push_back(currentShape);
-            currentShape.reset();
-            isDrawing = false;
+    case ShapeType::Polygon: {
+        auto& polygon = static_cast<class Polygon&>(*currentShape);
+        if (polygon.GetVertexCount() >= 3) {  // 至少3个顶点才能形成多边形
+            polygon.Close();
+            finished = true;
         }
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (finished) {
+        CommitShape(std::move(currentShape));
+        isDrawing = false;
     }
 }
 
@@ -208,14 +246,26 @@ void Canvas::OnMouseMove(int x, int y) {
     }
 }
 
-void Canvas::Draw(HDC hdc) {
-    // 绘制已完成的图形
-    for (const auto& shape : shapes) {
-        shape->Draw(hdc);
-    }
-
-    // 绘制当前正在绘制的图形
-    if (currentShape) {
+void Canvas::Draw(HDC hdc, int width, int height) {
+    // 已完成的图形画在缓存位图里，只重建失效的区域，且只重画与区域相交的图形
+    sceneCache.Resize(hdc, width, height);
+    frameStats.rebuiltPixels = 0;
+    sceneCache.TakeDirty(dirtyRegions);
+    for (const auto& region : dirtyRegions) {
+        HDC hdcScene = sceneCache.BeginRegion(region);
+        if (!hdcScene) break;
+        DrawShapes(hdcScene, region);
+        sceneCache.EndRegion();
+        frameStats.rebuiltPixels += (long long)(region.right - region.left + 1) * (region.bottom - region.top + 1);
+    }
+    frameStats.presentedPixels = sceneCache.Present(hdc);
+
+    // 以下为每帧叠加的预览层
+    // 绘制当前正在绘制的图形（在重绘区域外时跳过）
+    RECT paintBox;
+    bool hasPaintBox = GetClipBox(hdc, &paintBox) != ERROR_REGION;
+    Rect paintArea(paintBox.left, paintBox.top, paintBox.right - 1, paintBox.bottom - 1);
+    if (currentShape && hasPaintBox && currentShape->GetBounds().Intersects(paintArea)) {
         currentShape->Draw(hdc);
         currentShape->DrawPreview(hdc);
     }
@@ -350,70 +400,34 @@ void Canvas::Draw(HDC hdc) {
 }
 
 void Canvas::Clear() {
-    shapes.clear();
+    shapes.Clear();
+    shapeIndex.Clear();
+    DamageAll();
     currentShape.reset();
     isDrawing = false;
+    booleanFirst = ShapeHandle();
 }
 
 void Canvas::FillLastClosedShape(FillAlgorithm algorithm) {
-    // 查找最后一个可填充的图形(多段线、圆或矩形)
+    // 查找最后一个可填充的图形(多段线、圆、矩形、多边形或B样条)
     // 根据算法选择不同颜色
     COLORREF fillColor = (algorithm == FillAlgorithm::ScanLine) ? 
                          RGB(135, 206, 250) :  // 扫描线 - 浅蓝色
                          RGB(255, 182, 193);   // 栅栏填充 - 浅粉色
     
-    for (auto it = shapes.rbegin(); it != shapes.rend(); ++it) {
-        // 检查是否是多段线
-        if (auto polyline = std::dynamic_pointer_cast<class Polyline>(*it)) {
-            if (polyline->IsComplete() && polyline->GetPointCount() >= 3) {
-                auto filled = std::make_shared<FilledRegion>(
-                    polyline->GetPoints(), algorithm, fillColor);
-                shapes.push_back(filled);
-                return;
-            }
-        }
-        // 检查是否是圆
-        else if (auto circle = std::dynamic_pointer_cast<Circle>(*it)) {
-            if (circle->IsComplete()) {
-                // 获取圆的信息并转换为多边形点集
-                std::vector<Point> circlePoints = GetCirclePoints(circle);
-                if (circlePoints.size() >= 3) {
-                    auto filled = std::make_shared<FilledRegion>(
-                        circlePoints, algorithm, fillColor);
-                    shapes.push_back(filled);
-                    return;
-                }
-            }
-        }
-        // 检查是否是矩形
-        else if (auto rect = std::dynamic_pointer_cast<class Rectangle>(*it)) {
-            if (rect->IsComplete()) {
-                // 获取矩形的四个顶点
-                std::vector<Point> rectPoints = GetRectanglePoints(rect);
-                if (rectPoints.size() == 4) {
-                    auto filled = std::make_shared<FilledRegion>(
-                        rectPoints, algorithm, fillColor);
-                    shapes.push_back(filled);
-                    return;
-                }
-            }
-        }
-        // 检查是否是任意多边形
-        else if (auto polygon = std::dynamic_pointer_cast<class Polygon>(*it)) {
-            if (polygon->IsComplete() && polygon->GetVertexCount() >= 3) {
-                auto filled = std::make_shared<FilledRegion>(
-                    polygon->GetVertices(), algorithm, fillColor);
-                shapes.push_back(filled);
-                return;
-            }
+    std::vector<Point> outline;
+    std::vector<std::vector<Point>> holes;
+    for (size_t i = shapes.Size(); i-- > 0;) {
+        if (GetFillOutline(shapes[i], outline, holes)) {
+            CommitShape(std::make_unique<FilledRegion>(outline, algorithm, fillColor, holes));
+            return;
         }
     }
 }
 
 void Canvas::FillRegion(const std::vector<Point>& points, FillAlgorithm algorithm) {
     if (points.size() >= 3) {
-        auto filled = std::make_shared<FilledRegion>(points, algorithm, RGB(100, 150, 255));
-        shapes.push_back(filled);
+        CommitShape(std::make_unique<FilledRegion>(points, algorithm, RGB(100, 150, 255)));
     }
 }
 
@@ -424,77 +438,20 @@ void Canvas::StartSelectModeForFill(FillAlgorithm algorithm) {
 }
 
 void Canvas::SelectShapeAtPoint(int x, int y) {
-    // 从后往前遍历(选择最上层的图形)
-    for (int i = (int)shapes.size() - 1; i >= 0; i--) {
-        // 检查多段线
-        if (auto polyline = std::dynamic_pointer_cast<class Polyline>(shapes[i])) {
-            if (polyline->IsComplete() && polyline->GetPointCount() >= 3) {
-                // 简单的点在多边形内判断
-                const auto& pts = polyline->GetPoints();
-                bool inside = false;
-                for (size_t j = 0, k = pts.size() - 1; j < pts.size(); k = j++) {
-                    if (((pts[j].y > y) != (pts[k].y > y)) &&
-                        (x < (pts[k].x - pts[j].x) * (y - pts[j].y) / (pts[k].y - pts[j].y) + pts[j].x)) {
-                        inside = !inside;
-                    }
-                }
-                if (inside) {
-                    selectedShapeIndex = i;
-                    return;
-                }
-            }
-        }
-        // 检查圆
-        else if (auto circle = std::dynamic_pointer_cast<Circle>(shapes[i])) {
-            if (circle->IsComplete()) {
-                Point center = circle->GetCenter();
-                int radius = circle->GetRadius();
-                int dx = x - center.x;
-                int dy = y - center.y;
-                if (dx * dx + dy * dy <= radius * radius) {
-                    selectedShapeIndex = i;
-                    return;
-                }
-            }
-        }
-        // 检查矩形
-        else if (auto rect = std::dynamic_pointer_cast<class Rectangle>(shapes[i])) {
-            if (rect->IsComplete()) {
-                Point tl = rect->GetTopLeft();
-                Point br = rect->GetBottomRight();
-                int minX = std::min(tl.x, br.x);
-                int maxX = std::max(tl.x, br.x);
-                int minY = std::min(tl.y, br.y);
-                int maxY = std::max(tl.y, br.y);
-                if (x >= minX && x <= maxX && y >= minY && y <= maxY) {
-                    selectedShapeIndex = i;
-                    return;
-                }
-            }
-        }
-        // 检查任意多边形
-        else if (auto polygon = std::dynamic_pointer_cast<class Polygon>(shapes[i])) {
-            if (polygon->IsComplete() && polygon->GetVertexCount() >= 3) {
-                // 点在多边形内判断
-                const auto& verts = polygon->GetVertices();
-                bool inside = false;
-                for (size_t j = 0, k = verts.size() - 1; j < verts.size(); k = j++) {
-                    if (((verts[j].y > y) != (verts[k].y > y)) &&
-                        (x < (verts[k].x - verts[j].x) * (y - verts[j].y) / (verts[k].y - verts[j].y) + verts[j].x)) {
-                        inside = !inside;
-                    }
-                }
-                if (inside) {
-                    selectedShapeIndex = i;
-                    return;
-                }
-            }
+    // 只检查包围盒含有该点的图形，候选按从上到下排列(选择最上层的图形)
+    // 可填充的图形（闭合的多段线、圆、矩形、多边形、B样条）都按填充所用的轮廓和洞判断
+    Point p(x, y);
+    shapeIndex.Query(Rect(p, p), pickCandidates);
+    for (int i : pickCandidates) {
+        if (RegionContains(shapes[i], p)) {
+            selectedShapeIndex = i;
+            return;
         }
     }
 }
 
 void Canvas::FillSelectedShape() {
-    if (selectedShapeIndex < 0 || selectedShapeIndex >= (int)shapes.size()) {
+    if (selectedShapeIndex < 0 || selectedShapeIndex >= (int)shapes.Size()) {
         return;
     }
     
@@ -502,142 +459,88 @@ void Canvas::FillSelectedShape() {
                          RGB(135, 206, 250) :  // 扫描线 - 浅蓝色
                          RGB(255, 182, 193);   // 栅栏填充 - 浅粉色
     
-    auto& shape = shapes[selectedShapeIndex];
-    
-    // 检查是否是多段线
-    if (auto polyline = std::dynamic_pointer_cast<class Polyline>(shape)) {
-        if (polyline->IsComplete() && polyline->GetPointCount() >= 3) {
-            auto filled = std::make_shared<FilledRegion>(
-                polyline->GetPoints(), pendingFillAlgorithm, fillColor);
-            shapes.push_back(filled);
-        }
-    }
-    // 检查是否是圆
-    else if (auto circle = std::dynamic_pointer_cast<Circle>(shape)) {
-        if (circle->IsComplete()) {
-            std::vector<Point> circlePoints = GetCirclePoints(circle);
-            if (circlePoints.size() >= 3) {
-                auto filled = std::make_shared<FilledRegion>(
-                    circlePoints, pendingFillAlgorithm, fillColor);
-                shapes.push_back(filled);
-            }
-        }
-    }
-    // 检查是否是矩形
-    else if (auto rect = std::dynamic_pointer_cast<class Rectangle>(shape)) {
-        if (rect->IsComplete()) {
-            std::vector<Point> rectPoints = GetRectanglePoints(rect);
-            if (rectPoints.size() == 4) {
-                auto filled = std::make_shared<FilledRegion>(
-                    rectPoints, pendingFillAlgorithm, fillColor);
-                shapes.push_back(filled);
-            }
-        }
-    }
-    // 检查是否是任意多边形
-    else if (auto polygon = std::dynamic_pointer_cast<class Polygon>(shape)) {
-        if (polygon->IsComplete() && polygon->GetVertexCount() >= 3) {
-            auto filled = std::make_shared<FilledRegion>(
-                polygon->GetVertices(), pendingFillAlgorithm, fillColor);
-            shapes.push_back(filled);
-        }
-    }
-}
-
-std::vector<Point> Canvas::GetCirclePoints(std::shared_ptr<Circle> circle) {
-    std::vector<Point> points;
-    if (!circle) return points;
-    
-    Point center = circle->GetCenter();
-    int radius = circle->GetRadius();
-    
-    // 将圆近似为多边形(使用60个点)
-    const int numPoints = 60;
-    for (int i = 0; i < numPoints; i++) {
-        double angle = 2.0 * 3.14159265359 * i / numPoints;
-        int x = center.x + (int)(radius * cos(angle));
-        int y = center.y + (int)(radius * sin(angle));
-        points.push_back(Point(x, y));
+    std::vector<Point> outline;
+    std::vector<std::vector<Point>> holes;
+    if (GetFillOutline(shapes[selectedShapeIndex], outline, holes)) {
+        CommitShape(std::make_unique<FilledRegion>(outline, pendingFillAlgorithm, fillColor, holes));
     }
-    
-    return points;
 }
 
-std::vector<Point> Canvas::GetRectanglePoints(std::shared_ptr<class Rectangle> rect) {
-    std::vector<Point> points;
-    if (!rect) return points;
-    
-    Point topLeft = rect->GetTopLeft();
-    Point bottomRight = rect->GetBottomRight();
-    
-    // 矩形的四个顶点(按顺时针或逆时针顺序)
-    points.push_back(topLeft);                                          // 左上
-    points.push_back(Point(bottomRight.x, topLeft.y));                  // 右上
-    points.push_back(bottomRight);                                      // 右下
-    points.push_back(Point(topLeft.x, bottomRight.y));                  // 左下
-    
-    return points;
+// 填充使用图形缓存的轮廓：圆和B样条按屏幕上的误差容限折线化，只在图形变化后重新生成
+bool Canvas::GetFillOutline(const Shape& shape, std::vector<Point>& outline, std::vector<std::vector<Point>>& holes) {
+    const auto* cached = shape.GetOutline();
+    if (!cached || cached->size() < 3) return false;
+    outline = *cached;
+    const auto* cachedHoles = shape.GetHoles();
+    if (cachedHoles) {
+        holes = *cachedHoles;
+    } else {
+        holes.clear();
+    }
+    return true;
 }
 
-std::vector<Point> Canvas::GetPolylinePoints(std::shared_ptr<class Polyline> polyline) {
-    std::vector<Point> points;
-    if (!polyline || !polyline->IsComplete()) return points;
-    
-    // 多段线本身就是点集，直接返回
-    return polyline->GetPoints();
-}
-
-std::vector<Point> Canvas::GetBSplinePoints(std::shared_ptr<BSpline> bspline) {
-    std::vector<Point> points;
-    if (!bspline || !bspline->IsComplete()) return points;
-    
-    // B样条曲线需要将控制点转换为闭合多边形
-    // 使用控制点形成的凸包作为近似多边形
-    // 这里简单地使用控制点作为多边形顶点
-    // 更精确的方法是对曲线进行采样
-    const auto& controlPoints = bspline->GetPoints();
-    if (controlPoints.size() < 3) return points;
-    
-    // 将控制点作为多边形顶点返回
-    for (const auto& pt : controlPoints) {
-        points.push_back(pt);
+// 射线法（奇偶规则）：与填充一致，落在洞内的点不在区域内
+bool Canvas::RegionContains(const Shape& shape, const Point& p) {
+    const auto* outline = shape.GetOutline();
+    if (!outline || outline->size() < 3) return false;
+    const auto* holes = shape.GetHoles();
+    
+    bool inside = false;
+    size_t ringCount = 1 + (holes ? holes->size() : 0);
+    for (size_t ring = 0; ring < ringCount; ring++) {
+        const std::vector<Point>& pts = ring == 0 ? *outline : (*holes)[ring - 1];
+        for (size_t j = 0, k = pts.size() - 1; j < pts.size(); k = j++) {
+            if (((pts[j].y > p.y) != (pts[k].y > p.y)) &&
+                (p.x < (pts[k].x - pts[j].x) * (double)(p.y - pts[j].y) / (pts[k].y - pts[j].y) + pts[j].x)) {
+                inside = !inside;
+            }
+        }
     }
-    
-    return points;
+    return inside;
 }
 
 void Canvas::CreateNewShape() {
     switch (currentMode) {
     case DrawMode::Line:
-        currentShape = std::make_shared<Line>(LineAlgorithm::GDI);
+        currentShape = std::make_unique<Line>(LineAlgorithm::GDI);
         break;
     case DrawMode::LineMidpoint:
-        currentShape = std::make_shared<Line>(LineAlgorithm::Midpoint);
+        currentShape = std::make_unique<Line>(LineAlgorithm::Midpoint);
         break;
     case DrawMode::LineBresenham:
-        currentShape = std::make_shared<Line>(LineAlgorithm::Bresenham);
+        currentShape = std::make_unique<Line>(LineAlgorithm::Bresenham);
+        break;
+    case DrawMode::LineRunSlice:
+        currentShape = std::make_unique<Line>(LineAlgorithm::RunSlice);
         break;
     case DrawMode::Circle:
-        currentShape = std::make_shared<Circle>(CircleAlgorithm::GDI);
+        currentShape = std::make_unique<Circle>(CircleAlgorithm::GDI);
         break;
     case DrawMode::CircleMidpoint:
-        currentShape = std::make_shared<Circle>(CircleAlgorithm::Midpoint);
+        currentShape = std::make_unique<Circle>(CircleAlgorithm::Midpoint);
         break;
     case DrawMode::CircleBresenham:
-        currentShape = std::make_shared<Circle>(CircleAlgorithm::Bresenham);
+        currentShape = std::make_unique<Circle>(CircleAlgorithm::Bresenham);
         break;
     case DrawMode::Rectangle:
-        currentShape = std::make_shared<class Rectangle>();
+        currentShape = std::make_unique<class Rectangle>();
         break;
     case DrawMode::Polyline:
-        currentShape = std::make_shared<class Polyline>();
+        currentShape = std::make_unique<class Polyline>();
         break;
     case DrawMode::BSpline:
-        currentShape = std::make_shared<BSpline>();
+        currentShape = std::make_unique<BSpline>();
+        break;
+    case DrawMode::BSplineQuadratic:
+        currentShape = std::make_unique<BSpline>(2, BSpline::KnotType::Uniform);
+        break;
+    case DrawMode::BSplineClamped:
+        currentShape = std::make_unique<BSpline>(3, BSpline::KnotType::Clamped);
         break;
     // 实验二新增
     case DrawMode::Polygon:
-        currentShape = std::make_shared<class Polygon>();
+        currentShape = std::make_unique<class Polygon>();
         break;
     default:
         break;
@@ -646,16 +549,24 @@ void Canvas::CreateNewShape() {
 
 // ==================== 实验二：图形选择功能 ====================
 
+// 命中测试可能接受的离图形最远的距离（B 样条控制点的容差为 tolerance + 5）
+static const int PICK_MARGIN = 10;
+
 void Canvas::SelectShapeAt(const Point& p) {
-    if (selectedShapeIndex >= 0 && selectedShapeIndex < (int)shapes.size()) {
-        shapes[selectedShapeIndex]->SetSelected(false);
+    if (selectedShapeIndex >= 0 && selectedShapeIndex < (int)shapes.Size()) {
+        // 选中高亮的范围更大，先按选中时的包围盒标记
+        DamageShape(shapes[selectedShapeIndex]);
+        shapes[selectedShapeIndex].SetSelected(false);
     }
     
+    // 只检查包围盒靠近该点的图形，候选按从上到下排列
     selectedShapeIndex = -1;
-    for (int i = shapes.size() - 1; i >= 0; i--) {
-        if (shapes[i]->HitTest(p, 5)) {
+    shapeIndex.Query(Rect(p, p).Inflate(PICK_MARGIN), pickCandidates);
+    for (int i : pickCandidates) {
+        if (shapes[i].HitTest(p, 5)) {
             selectedShapeIndex = i;
-            shapes[i]->SetSelected(true);
+            shapes[i].SetSelected(true);
+            DamageShape(shapes[i]);
             break;
         }
     }
@@ -665,16 +576,18 @@ int Canvas::GetSelectedShapeIndex() const {
     return selectedShapeIndex;
 }
 
-std::shared_ptr<Shape> Canvas::GetSelectedShape() {
-    if (selectedShapeIndex >= 0 && selectedShapeIndex < (int)shapes.size()) {
-        return shapes[selectedShapeIndex];
+Shape* Canvas::GetSelectedShape() {
+    if (selectedShapeIndex >= 0 && selectedShapeIndex < (int)shapes.Size()) {
+        return &shapes[selectedShapeIndex];
     }
     return nullptr;
 }
 
 void Canvas::ClearSelection() {
-    if (selectedShapeIndex >= 0 && selectedShapeIndex < (int)shapes.size()) {
-        shapes[selectedShapeIndex]->SetSelected(false);
+    if (selectedShapeIndex >= 0 && selectedShapeIndex < (int)shapes.Size()) {
+        // 选中高亮的范围更大，先按选中时的包围盒标记
+        DamageShape(shapes[selectedShapeIndex]);
+        shapes[selectedShapeIndex].SetSelected(false);
     }
     selectedShapeIndex = -1;
 }
@@ -684,21 +597,30 @@ void Canvas::ClearSelection() {
 void Canvas::TranslateSelectedShape(int dx, int dy) {
     auto shape = GetSelectedShape();
     if (shape) {
+        DamageShape(*shape);
         shape->Translate(dx, dy);
+        DamageShape(*shape);
+        shapeIndex.Insert(selectedShapeIndex, shape->GetBounds());
     }
 }
 
 void Canvas::ScaleSelectedShape(double sx, double sy, const Point& center) {
     auto shape = GetSelectedShape();
     if (shape) {
+        DamageShape(*shape);
         shape->Scale(sx, sy, center);
+        DamageShape(*shape);
+        shapeIndex.Insert(selectedShapeIndex, shape->GetBounds());
     }
 }
 
 void Canvas::RotateSelectedShape(double angleRad, const Point& center) {
     auto shape = GetSelectedShape();
     if (shape) {
+        DamageShape(*shape);
         shape->Rotate(angleRad, center);
+        DamageShape(*shape);
+        shapeIndex.Insert(selectedShapeIndex, shape->GetBounds());
     }
 }
 
@@ -724,11 +646,17 @@ Rect Canvas::GetClipRect() const {
 void Canvas::ClipLines(LineClipAlgorithm algorithm) {
     if (!hasClipRect) return;
     
-    for (auto& shape : shapes) {
-        auto line = std::dynamic_pointer_cast<Line>(shape);
-        if (line && line->IsComplete()) {
-            Point p1 = line->GetStart();
-            Point p2 = line->GetEnd();
+    // 直接遍历连续存放的直线，不需要按绘制顺序
+    bool changed = false;
+    for (auto& line : shapes.Lines()) {
+        // 包围盒完全在窗口外（两种算法都判为不可见，直线保持不变）
+        // 或完全在窗口内（端点不变）时无需裁剪
+        Rect bounds = line.GetBounds();
+        if (!bounds.Intersects(clipRect) || clipRect.Contains(bounds)) continue;
+        
+        if (line.IsComplete()) {
+            Point p1 = line.GetStart();
+            Point p2 = line.GetEnd();
             
             bool visible = false;
             if (algorithm == LineClipAlgorithm::CohenSutherland) {
@@ -739,58 +667,53 @@ void Canvas::ClipLines(LineClipAlgorithm algorithm) {
             }
             
             if (visible) {
-                line->SetEndpoints(p1, p2);
+                DamageShape(line);
+                line.SetEndpoints(p1, p2);
+                DamageShape(line);
+                changed = true;
             }
         }
     }
+    
+    // 裁剪改变了图形的包围盒
+    if (changed) {
+        RebuildShapeIndex();
+    }
 }
 
 void Canvas::ClipPolygons(PolygonClipAlgorithm algorithm) {
     if (!hasClipRect) return;
+    // 裁剪会删除或替换图形，放弃布尔运算中已选的图形，以免其高亮被带到裁剪结果上
+    CancelBooleanPick();
     
     // 用于存储裁剪后的图形
-    std::vector<std::shared_ptr<Shape>> clippedShapes;
+    std::vector<std::unique_ptr<Shape>> clippedShapes;
     // 用于存储需要删除的原始图形索引
     std::vector<size_t> indicesToRemove;
     
-    for (size_t i = 0; i < shapes.size(); i++) {
-        auto& shape = shapes[i];
+    for (size_t i = 0; i < shapes.Size(); i++) {
         std::vector<Point> inVerts;
+        std::vector<std::vector<Point>> inHoles;
         bool needsClipping = false;
+        bool selected = false;
+        Rect bounds;
         
-        // 处理多边形
-        if (auto polygon = std::dynamic_pointer_cast<class Polygon>(shape)) {
-            if (polygon->IsComplete()) {
-                inVerts = polygon->GetVertices();
-                needsClipping = true;
-            }
-        }
-        // 处理圆形
-        else if (auto circle = std::dynamic_pointer_cast<Circle>(shape)) {
-            if (circle->IsComplete()) {
-                inVerts = GetCirclePoints(circle);
-                needsClipping = true;
-            }
-        }
-        // 处理矩形
-        else if (auto rect = std::dynamic_pointer_cast<class Rectangle>(shape)) {
-            if (rect->IsComplete()) {
-                inVerts = GetRectanglePoints(rect);
-                needsClipping = true;
-            }
-        }
-        // 处理多段线
-        else if (auto polyline = std::dynamic_pointer_cast<class Polyline>(shape)) {
-            if (polyline->IsComplete()) {
-                inVerts = GetPolylinePoints(polyline);
+        {
+            const Shape& shape = shapes[i];
+            
+            // 用包围盒快速判断：完全在窗口外时 Sutherland-Hodgman 结果为空（图形保持不变），
+            // Weiler-Atherton 没有交点也不被包含（图形被删除）；完全在窗口内时两者都原样返回顶点
+            bounds = shape.GetBounds();
+            if (!bounds.Intersects(clipRect) && algorithm == PolygonClipAlgorithm::SutherlandHodgman) continue;
+            selected = shape.IsSelected();
+            
+            // 可以构成区域的图形（多边形、圆、矩形、闭合多段线、B样条）按图形缓存的轮廓裁剪
+            if (const auto* outline = shape.GetOutline()) {
+                inVerts = *outline;
                 needsClipping = true;
             }
-        }
-        // 处理B样条曲线
-        else if (auto bspline = std::dynamic_pointer_cast<BSpline>(shape)) {
-            if (bspline->IsComplete()) {
-                inVerts = GetBSplinePoints(bspline);
-                needsClipping = true;
+            if (const auto* holes = shape.GetHoles()) {
+                inHoles = *holes;
             }
         }
         
@@ -798,47 +721,83 @@ void Canvas::ClipPolygons(PolygonClipAlgorithm algorithm) {
         if (needsClipping && inVerts.size() >= 3) {
             if (algorithm == PolygonClipAlgorithm::SutherlandHodgman) {
                 std::vector<Point> outVerts;
-                bool visible = DrawingAlgorithm::ClipPolygon_SutherlandHodgman(clipRect, inVerts, outVerts);
+                std::vector<std::vector<Point>> outHoles;
+                bool visible = true;
+                if (clipRect.Contains(bounds)) {
+                    outVerts = inVerts;
+                    outHoles = inHoles;
+                } else {
+                    visible = DrawingAlgorithm::ClipPolygon_SutherlandHodgman(clipRect, inVerts, outVerts);
+                    // 洞分别裁剪，完全落在窗口外的洞随之消失
+                    for (const auto& hole : inHoles) {
+                        std::vector<Point> clipped;
+                        if (DrawingAlgorithm::ClipPolygon_SutherlandHodgman(clipRect, hole, clipped) && clipped.size() >= 3) {
+                            outHoles.push_back(clipped);
+                        }
+                    }
+                }
                 
                 // 更新图形顶点
                 if (visible && outVerts.size() >= 3) {
+                    DamageShape(shapes[i]);
                     // 对于多边形，直接更新顶点
-                    if (auto polygon = std::dynamic_pointer_cast<class Polygon>(shape)) {
-                        polygon->SetVertices(outVerts);
+                    if (shapes.TypeAt(i) == ShapeType::Polygon) {
+                        static_cast<class Polygon&>(shapes[i]).SetVertices(outVerts, outHoles);
                     }
                     // 对于其他图形类型，创建新的多边形替换原图形
                     else {
-                        auto newPolygon = std::make_shared<class Polygon>();
-                        newPolygon->SetVertices(outVerts);
+                        auto newPolygon = std::make_unique<class Polygon>();
+                        newPolygon->SetVertices(outVerts, outHoles);
                         newPolygon->Close();
                         // 保持选中状态
-                        if (shape->IsSelected()) {
+                        if (selected) {
                             newPolygon->SetSelected(true);
                         }
-                        shape = newPolygon;
+                        shapes.Replace(i, std::move(newPolygon));
                     }
+                    DamageShape(shapes[i]);
                 }
             }
             else if (algorithm == PolygonClipAlgorithm::WeilerAtherton) {
                 // Weiler-Atherton 算法：只保留框内部分
                 // 注意：WeilerAtherton 可能返回多个裁剪结果
-                auto results = DrawingAlgorithm::ClipPolygon_WeilerAtherton(clipRect, inVerts);
+                // 完全包含要求顶点严格在窗口内部（落在右、下边上的点不算在窗口内）
+                // 每个结果是一个外环后跟它内部的洞
+                std::vector<PolygonBoolean::Rings> results;
+                bool inside = bounds.left > clipRect.left && bounds.right < clipRect.right &&
+                              bounds.top > clipRect.top && bounds.bottom < clipRect.bottom;
+                if (inside) {
+                    results.push_back({ inVerts });
+                    results.back().insert(results.back().end(), inHoles.begin(), inHoles.end());
+                } else if (bounds.Intersects(clipRect) && inHoles.empty()) {
+                    for (auto& outVerts : DrawingAlgorithm::ClipPolygon_WeilerAtherton(clipRect, inVerts)) {
+                        results.push_back({ std::move(outVerts) });
+                    }
+                } else if (bounds.Intersects(clipRect)) {
+                    // 带洞的图形（布尔运算的结果）：区域与窗口求交，再把结果环按外环分组
+                    PolygonBoolean::Rings rings = { inVerts };
+                    rings.insert(rings.end(), inHoles.begin(), inHoles.end());
+                    PolygonBoolean::Rings window = { {
+                        Point(clipRect.left, clipRect.top), Point(clipRect.right, clipRect.top),
+                        Point(clipRect.right, clipRect.bottom), Point(clipRect.left, clipRect.bottom) } };
+                    PolygonBoolean::GroupRings(DrawingAlgorithm::BooleanPolygons(rings, window, BooleanOp::Intersection), results);
+                }
                 
                 // 标记原始图形待删除
                 indicesToRemove.push_back(i);
                 
                 // 处理所有裁剪结果（保留框内部分）
-                for (const auto& outVerts : results) {
-                    if (outVerts.size() >= 3) {
+                for (const auto& polygon : results) {
+                    if (polygon[0].size() >= 3) {
                         // 创建裁剪后的多边形（只保留框内部分）
-                        auto newPolygon = std::make_shared<class Polygon>();
-                        newPolygon->SetVertices(outVerts);
+                        auto newPolygon = std::make_unique<class Polygon>();
+                        newPolygon->SetVertices(polygon[0], PolygonBoolean::Rings(polygon.begin() + 1, polygon.end()));
                         newPolygon->Close();
                         // 保持选中状态
-                        if (shape->IsSelected()) {
+                        if (selected) {
                             newPolygon->SetSelected(true);
                         }
-                        clippedShapes.push_back(newPolygon);
+                        clippedShapes.push_back(std::move(newPolygon));
                     }
                 }
             }
@@ -847,15 +806,202 @@ void Canvas::ClipPolygons(PolygonClipAlgorithm algorithm) {
     
     // 使用 Weiler-Atherton 时，删除原始图形并添加裁剪后的图形
     if (algorithm == PolygonClipAlgorithm::WeilerAtherton && !indicesToRemove.empty()) {
-        // 从后往前删除，避免索引变化
-        for (auto it = indicesToRemove.rbegin(); it != indicesToRemove.rend(); ++it) {
-            shapes.erase(shapes.begin() + *it);
+        // 一次删除所有原始图形，其余图形保持原顺序
+        for (size_t index : indicesToRemove) {
+            DamageShape(shapes[index]);
         }
+        shapes.Erase(indicesToRemove);
         // 添加裁剪后的图形
-        shapes.insert(shapes.end(), clippedShapes.begin(), clippedShapes.end());
+        for (auto& clipped : clippedShapes) {
+            DamageShape(*clipped);
+            shapes.Add(std::move(clipped));
+        }
+    }
+    
+    // 裁剪改变了图形的包围盒，且删除图形会改变后面图形的下标
+    RebuildShapeIndex();
+}
+
+// ==================== 多边形布尔运算 ====================
+
+void Canvas::StartBooleanMode(BooleanOp op) {
+    SetDrawMode(DrawMode::Boolean);
+    pendingBooleanOp = op;
+}
+
+void Canvas::CancelBooleanPick() {
+    if (Shape* shape = shapes.Get(booleanFirst)) {
+        DamageShape(*shape);
+        shape->SetSelected(false);
+    }
+    booleanFirst = ShapeHandle();
+}
+
+bool Canvas::CombineShapes(ShapeHandle firstHandle, ShapeHandle secondHandle, BooleanOp op) {
+    // 按句柄找到两个图形当前的位置；句柄失效说明图形已被删除或替换，不做运算
+    int first = shapes.IndexOf(firstHandle);
+    int second = shapes.IndexOf(secondHandle);
+    if (first < 0 || second < 0 || first == second) return false;
+    
+    // 两个图形的区域都由轮廓和洞组成
+    PolygonBoolean::Rings subject(1), clip(1), holes;
+    if (!GetFillOutline(shapes[first], subject[0], holes)) return false;
+    subject.insert(subject.end(), holes.begin(), holes.end());
+    if (!GetFillOutline(shapes[second], clip[0], holes)) return false;
+    clip.insert(clip.end(), holes.begin(), holes.end());
+    
+    // 差集、异或的结果可能带洞：洞与包含它的外环放在同一个多边形中，填充和轮廓都按奇偶规则处理
+    std::vector<PolygonBoolean::Rings> results;
+    PolygonBoolean::GroupRings(DrawingAlgorithm::BooleanPolygons(subject, clip, op), results);
+    
+    // 删除两个原始图形（删除会改变后面图形的下标），结果加在最上层
+    DamageShape(shapes[first]);
+    DamageShape(shapes[second]);
+    shapes.Erase({ (size_t)std::min(first, second), (size_t)std::max(first, second) });
+    if (selectedShapeIndex == first || selectedShapeIndex == second) {
+        selectedShapeIndex = -1;
+    }
+    RebuildShapeIndex();
+    
+    for (const auto& rings : results) {
+        auto polygon = std::make_unique<class Polygon>();
+        polygon->SetVertices(rings[0], PolygonBoolean::Rings(rings.begin() + 1, rings.end()));
+        polygon->Close();
+        CommitShape(std::move(polygon));
+    }
+    return true;
+}
+
+void Canvas::CommitShape(std::unique_ptr<Shape> shape) {
+    Rect bounds = shape->GetBounds();
+    shapes.Add(std::move(shape));
+    shapeIndex.Insert((int)shapes.Size() - 1, bounds);
+    DamageScene(bounds);
+}
+
+void Canvas::RebuildShapeIndex() {
+    shapeIndex.Clear();
+    for (size_t i = 0; i < shapes.Size(); i++) {
+        shapeIndex.Insert((int)i, shapes[i].GetBounds());
+    }
+}
+
+void Canvas::DamageScene(const Rect& area) {
+    sceneCache.Invalidate(area);
+    damage.Add(area);
+}
+
+void Canvas::DamageShape(const Shape& shape) {
+    DamageScene(shape.GetBounds());
+}
+
+void Canvas::DamageAll() {
+    sceneCache.Invalidate();
+    damage.AddAll();
+}
+
+// 文字提示的大致范围（默认字体下足以容纳提示文本）
+static const int OVERLAY_TEXT_WIDTH = 200;
+static const int OVERLAY_TEXT_HEIGHT = 24;
+
+void Canvas::GetOverlayBounds(std::vector<Rect>& out) const {
+    out.clear();
+
+    if (currentShape) {
+        out.push_back(currentShape->GetBounds());
+    }
+    if (hasClipRect) {
+        out.push_back(clipRect.Inflate(2));
+    }
+    if (currentMode == DrawMode::SetClipWindow && hasTransformAnchor) {
+        out.push_back(Rect(transformAnchor, previewPoint).Inflate(1));
+    }
+    if (currentMode == DrawMode::Translate && isDragging && selectedShapeIndex >= 0) {
+        // 平移向量、箭头和中点上方的文字
+        out.push_back(Rect(dragStart, previewPoint).Inflate(12));
+        int textX = (dragStart.x + previewPoint.x) / 2;
+        int textY = (dragStart.y + previewPoint.y) / 2 - 20;
+        out.push_back(Rect(textX, textY, textX + OVERLAY_TEXT_WIDTH, textY + OVERLAY_TEXT_HEIGHT));
+    }
+    if ((currentMode == DrawMode::Scale || currentMode == DrawMode::Rotate) &&
+        hasTransformAnchor && selectedShapeIndex >= 0) {
+        // 中心点标记、两条参考线和中心点右下方的文字
+        out.push_back(Rect(transformAnchor, dragStart).Union(Rect(transformAnchor, previewPoint)).Inflate(6));
+        out.push_back(Rect(transformAnchor.x + 10, transformAnchor.y + 10,
+                           transformAnchor.x + 10 + OVERLAY_TEXT_WIDTH, transformAnchor.y + 10 + OVERLAY_TEXT_HEIGHT));
     }
 }
 
+bool Canvas::TakeDamage(std::vector<Rect>& rects) {
+    // 预览层范围有变化时，新旧范围都要重绘（旧范围由缓存位图恢复）
+    GetOverlayBounds(overlayScratch);
+    bool overlayChanged = overlayScratch.size() != overlayBounds.size();
+    for (size_t i = 0; !overlayChanged && i < overlayScratch.size(); i++) {
+        const Rect& a = overlayScratch[i];
+        const Rect& b = overlayBounds[i];
+        overlayChanged = a.left != b.left || a.top != b.top || a.right != b.right || a.bottom != b.bottom;
+    }
+    if (overlayChanged) {
+        for (const auto& r : overlayBounds) damage.Add(r);
+        for (const auto& r : overlayScratch) damage.Add(r);
+        overlayBounds.swap(overlayScratch);
+    }
+
+    bool full = damage.IsFull();
+    rects = damage.Rects();
+    damage.Clear();
+    return !full;
+}
+
+const Canvas::FrameStats& Canvas::GetFrameStats() const {
+    return frameStats;
+}
+
+void Canvas::DrawShapes(HDC hdc, const Rect& area) {
+    // 只画与区域相交的图形，相对顺序不变
+    visibleShapes.clear();
+    for (size_t i = 0; i < shapes.Size(); i++) {
+        if (shapes[i].GetBounds().Intersects(area)) {
+            visibleShapes.push_back(i);
+        }
+    }
+
+    size_t i = 0;
+    while (i < visibleShapes.size()) {
+        // 找出从 i 开始连续的一段可光栅化图形
+        size_t end = i;
+        while (end < visibleShapes.size() && shapes[visibleShapes[end]].CanRasterize()) {
+            end++;
+        }
+
+        if (end > i) {
+            RasterizeShapes(hdc, i, end);
+            i = end;
+        } else {
+            // 使用 GDI 画笔的图形保持原顺序串行绘制
+            shapes[visibleShapes[i]].Draw(hdc);
+            i++;
+        }
+    }
+}
+
+void Canvas::RasterizeShapes(HDC hdc, size_t first, size_t last) {
+    rasterBounds.clear();
+    Rect area = shapes[visibleShapes[first]].GetBounds();
+    for (size_t i = first; i < last; i++) {
+        rasterBounds.push_back(shapes[visibleShapes[i]].GetBounds());
+        area = area.Union(rasterBounds.back());
+    }
+
+    // 整批共用一个光栅目标（双缓冲是 32bpp DIB 段时直接写其内存）
+    HdcRaster raster(hdc, area);
+    if (raster.IsEmpty()) return;
+
+    tileRenderer.Render(raster.Target(), rasterBounds, [&](size_t index, RasterTarget& tile) {
+        shapes[visibleShapes[first + index]].Rasterize(tile);
+    });
+}
+
 void Canvas::DrawClipRect(HDC hdc) {
     if (!hasClipRect) return;
     
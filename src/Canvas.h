@@ -3,8 +3,13 @@
 #include <vector>
 #include <memory>
 #include "Shape.h"
+#include "ShapeStore.h"
 #include "Point.h"
 #include "DrawingAlgorithm.h"
+#include "TileRenderer.h"
+#include "SceneCache.h"
+#include "DamageRegion.h"
+#include "SpatialGrid.h"
 
 // 绘制模式枚举
 enum class DrawMode {
@@ -12,25 +17,29 @@ enum class DrawMode {
     Line,
     LineMidpoint,
     LineBresenham,
+    LineRunSlice,
     Circle,
     CircleMidpoint,
     CircleBresenham,
     Rectangle,
     Polyline,
     BSpline,
+    BSplineQuadratic,  // 二次均匀 B 样条
+    BSplineClamped,    // 端点插值的三次 B 样条（NURBS 节点向量）
     // 实验二新增
     Polygon,           // 任意多边形
     Translate,         // 平移模式
     Scale,             // 缩放模式
     Rotate,            // 旋转模式
-    SetClipWindow      // 设置裁剪窗口模式
+    SetClipWindow,     // 设置裁剪窗口模式
+    Boolean            // 布尔运算模式（依次选择两个图形）
 };
 
 // 画布类 - 管理所有图形和绘制操作
 class Canvas {
 private:
-    std::vector<std::shared_ptr<Shape>> shapes;      // 已完成的图形
-    std::shared_ptr<Shape> currentShape;              // 当前正在绘制的图形
+    ShapeStore shapes;                                // 已完成的图形（按类型分池存放）
+    std::unique_ptr<Shape> currentShape;              // 当前正在绘制的图形
     DrawMode currentMode;                             // 当前绘制模式
     Point previewPoint;                               // 鼠标预览点
     bool isDrawing;                                   // 是否正在绘制
@@ -45,8 +54,45 @@ private:
     bool hasTransformAnchor;                          // 是否设置了变换锚点
     Point dragStart;                                  // 拖拽起点（用于平移）
     bool isDragging;                                  // 是否正在拖拽
+    BooleanOp pendingBooleanOp;                       // 待执行的布尔运算
+    ShapeHandle booleanFirst;                         // 布尔运算已选中的第一个图形（空句柄表示未选）
+    
+    TileRenderer tileRenderer;                        // 分块并行光栅化
+    std::vector<Rect> rasterBounds;                   // 并行绘制批次中各图形的包围盒
+    SceneCache sceneCache;                            // 已完成图形的缓存位图
+    std::vector<Rect> dirtyRegions;                   // 本帧需要重建的缓存区域
+    std::vector<size_t> visibleShapes;                // 与重建区域相交的图形下标
+    DamageRegion damage;                              // 窗口需要重绘的区域
+    std::vector<Rect> overlayBounds;                  // 上次取出重绘区域时预览层的范围
+    std::vector<Rect> overlayScratch;
+    SpatialGrid shapeIndex;                           // 图形包围盒的空间索引（编号即 shapes 中的下标）
+    std::vector<int> pickCandidates;                  // 选择时的候选图形（从上到下）
+    
+public:
+    // 每帧的重绘统计（像素数）
+    struct FrameStats {
+        long long rebuiltPixels = 0;                  // 缓存位图中重新光栅化的像素
+        long long presentedPixels = 0;                // 复制到后备缓冲（即重绘）的像素
+    };
+    
+private:
+    FrameStats frameStats;
     
     void CreateNewShape();
+    // 加入一个已完成的图形并标记其范围需要重绘
+    void CommitShape(std::unique_ptr<Shape> shape);
+    // 按当前图形列表重建空间索引（删除图形使下标变化时调用）
+    void RebuildShapeIndex();
+    // 标记已完成图形所在的区域需要重绘（缓存与窗口都失效）；图形变化前后各调用一次
+    void DamageScene(const Rect& area);
+    void DamageShape(const Shape& shape);
+    void DamageAll();
+    // 预览层（当前图形、裁剪窗口、变换提示）可能触及的范围
+    void GetOverlayBounds(std::vector<Rect>& out) const;
+    // 绘制与 area 相交的已完成图形：连续的可光栅化图形分块并行绘制，其余图形按顺序用 GDI 绘制
+    void DrawShapes(HDC hdc, const Rect& area);
+    // 并行绘制 visibleShapes[first, last) 对应的图形（都可光栅化）
+    void RasterizeShapes(HDC hdc, size_t first, size_t last);
     
 public:
     Canvas();
@@ -55,7 +101,14 @@ public:
     void OnMouseLeftDown(int x, int y);
     void OnMouseRightDown(int x, int y);
     void OnMouseMove(int x, int y);
-    void Draw(HDC hdc);
+    // 绘制到 width × height 的后备缓冲（只绘制 hdc 裁剪框内的部分）：
+    // 先复制已完成图形的缓存，再叠加预览与辅助标记
+    void Draw(HDC hdc, int width, int height);
+    // 取出自上次调用以来窗口需要重绘的区域（包含边界的画布坐标）；
+    // 返回 false 表示整个窗口都需要重绘
+    bool TakeDamage(std::vector<Rect>& rects);
+    // 最近一帧的重绘统计
+    const FrameStats& GetFrameStats() const;
     void Clear();
     void FillLastClosedShape(FillAlgorithm algorithm);
     void FillRegion(const std::vector<Point>& points, FillAlgorithm algorithm);
@@ -66,7 +119,8 @@ public:
     // ==================== 实验二：图形选择功能 ====================
     void SelectShapeAt(const Point& p);
     int GetSelectedShapeIndex() const;
-    std::shared_ptr<Shape> GetSelectedShape();
+    // 返回的指针在图形增删后失效
+    Shape* GetSelectedShape();
     void ClearSelection();
     
     // ==================== 实验二：图形变换功能 ====================
@@ -83,13 +137,19 @@ public:
     void ClipPolygons(PolygonClipAlgorithm algorithm);
     void DrawClipRect(HDC hdc);
     
+    // ==================== 多边形布尔运算 ====================
+    // 进入布尔运算模式：依次点击两个可构成区域的图形，用两者的运算结果替换它们
+    void StartBooleanMode(BooleanOp op);
+    // 对句柄 first、second 所指图形的区域（轮廓和洞）做布尔运算，删除两个图形，
+    // 把结果的每个外环连同它内部的洞作为一个多边形加在最上层；
+    // 句柄失效（图形已被删除或替换）、两者相同或不能构成区域时返回 false，图形保持不变
+    bool CombineShapes(ShapeHandle first, ShapeHandle second, BooleanOp op);
+    
 private:
-    // 辅助函数：将圆转换为多边形点集
-    std::vector<Point> GetCirclePoints(std::shared_ptr<Circle> circle);
-    // 辅助函数：将矩形转换为多边形点集
-    std::vector<Point> GetRectanglePoints(std::shared_ptr<class Rectangle> rect);
-    // 辅助函数：将多段线转换为多边形点集
-    std::vector<Point> GetPolylinePoints(std::shared_ptr<class Polyline> polyline);
-    // 辅助函数：将B样条曲线转换为多边形点集
-    std::vector<Point> GetBSplinePoints(std::shared_ptr<BSpline> bspline);
+    // 放弃布尔运算中已选的第一个图形并取消其高亮
+    void CancelBooleanPick();
+    // 可填充图形（闭合的多段线、圆、矩形、多边形、B样条）的轮廓和洞，不可填充时返回 false
+    bool GetFillOutline(const Shape& shape, std::vector<Point>& outline, std::vector<std::vector<Point>>& holes);
+    // 点是否落在可填充图形的区域内（轮廓和洞按奇偶规则），不可填充的图形返回 false
+    static bool RegionContains(const Shape& shape, const Point& p);
 };
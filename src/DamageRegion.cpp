@@ -0,0 +1,28 @@
+#include "DamageRegion.h"
+
+void DamageRegion::Add(const Rect& r) {
+    if (full || r.left > r.right || r.top > r.bottom) return;
+
+    // 与已有矩形相交就合并，合并后可能又与别的矩形相交，重复直到不再相交
+    Rect merged = r;
+    size_t i = 0;
+    while (i < rects.size()) {
+        if (rects[i].Intersects(merged)) {
+            merged = merged.Union(rects[i]);
+            rects[i] = rects.back();
+            rects.pop_back();
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    rects.push_back(merged);
+
+    if ((int)rects.size() > MAX_RECTS) {
+        Rect all = rects[0];
+        for (const auto& rect : rects) {
+            all = all.Union(rect);
+        }
+        rects.assign(1, all);
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+#include "Point.h"
+
+// 待重绘区域：若干互不相交的矩形（包含边界）
+// 新矩形与已有矩形相交时合并为二者的并；矩形过多时退化为所有矩形的并
+class DamageRegion {
+public:
+    static const int MAX_RECTS = 16;
+
+    DamageRegion() : full(false) {}
+
+    void Add(const Rect& r);
+    // 整个表面都需要重绘
+    void AddAll() { full = true; rects.clear(); }
+    void Clear() { full = false; rects.clear(); }
+
+    bool IsFull() const { return full; }
+    bool IsEmpty() const { return !full && rects.empty(); }
+    // IsFull 为 true 时没有意义
+    const std::vector<Rect>& Rects() const { return rects; }
+
+private:
+    std::vector<Rect> rects;
+    bool full;
+};
@@ -1,30 +1,30 @@
 #include "DrawingAlgorithm.h"
+#include "SpanWriter.h"
 
 // ============ 公共接口实现 ============
 
+#ifdef _WIN32
+// HDC 版本：GDI 算法直接调用 GDI，软件算法光栅化到 HdcRaster 提供的内存表面
+
 void DrawingAlgorithm::DrawLine(HDC hdc, int x1, int y1, int x2, int y2, LineAlgorithm algorithm, COLORREF color) {
-    switch (algorithm) {
-    case LineAlgorithm::GDI: {
+    if (algorithm == LineAlgorithm::GDI) {
         HPEN hPen = CreatePen(PS_SOLID, 1, color);
         HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
         MoveToEx(hdc, x1, y1, NULL);
         LineTo(hdc, x2, y2);
         SelectObject(hdc, hOldPen);
         DeleteObject(hPen);
-        break;
+        return;
     }
-    case LineAlgorithm::Midpoint:
-        DrawLineMidpoint(hdc, x1, y1, x2, y2, color);
-        break;
-    case LineAlgorithm::Bresenham:
-        DrawLineBresenham(hdc, x1, y1, x2, y2, color);
-        break;
+
+    HdcRaster raster(hdc, Rect(Point(x1, y1), Point(x2, y2)));
+    if (!raster.IsEmpty()) {
+        DrawLine(raster.Target(), x1, y1, x2, y2, algorithm, color);
     }
 }
 
 void DrawingAlgorithm::DrawCircle(HDC hdc, int centerX, int centerY, int radius, CircleAlgorithm algorithm, COLORREF color) {
-    switch (algorithm) {
-    case CircleAlgorithm::GDI: {
+    if (algorithm == CircleAlgorithm::GDI) {
         HPEN hPen = CreatePen(PS_SOLID, 1, color);
         HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
         HBRUSH hBrush = (HBRUSH)GetStockObject(NULL_BRUSH);
@@ -33,212 +33,521 @@ void DrawingAlgorithm::DrawCircle(HDC hdc, int centerX, int centerY, int radius,
         SelectObject(hdc, hOldPen);
         SelectObject(hdc, hOldBrush);
         DeleteObject(hPen);
-        break;
+        return;
+    }
+
+    HdcRaster raster(hdc, Rect(centerX - radius, centerY - radius, centerX + radius, centerY + radius));
+    if (!raster.IsEmpty()) {
+        DrawCircle(raster.Target(), centerX, centerY, radius, algorithm, color);
+    }
+}
+
+void DrawingAlgorithm::FillPolygon(HDC hdc, const std::vector<Point>& points, FillAlgorithm algorithm, COLORREF color) {
+    if (points.size() < 3) return;
+
+    HdcRaster raster(hdc, GetPolygonBounds(points));
+    if (!raster.IsEmpty()) {
+        FillPolygon(raster.Target(), points, algorithm, color);
+    }
+}
+
+void DrawingAlgorithm::FillPolygon(HDC hdc, const std::vector<Point>& outer, const std::vector<std::vector<Point>>& holes,
+                                   FillAlgorithm algorithm, COLORREF color) {
+    if (outer.size() < 3) return;
+
+    HdcRaster raster(hdc, GetPolygonBounds(outer));
+    if (!raster.IsEmpty()) {
+        FillPolygon(raster.Target(), outer, holes, algorithm, color);
+    }
+}
+
+void DrawingAlgorithm::FillCircle(HDC hdc, int centerX, int centerY, int radius, COLORREF color) {
+    HdcRaster raster(hdc, Rect(centerX - radius, centerY - radius, centerX + radius, centerY + radius));
+    if (!raster.IsEmpty()) {
+        FillCircle(raster.Target(), centerX, centerY, radius, color);
+    }
+}
+
+// 一组坐标的包围盒（包含边界）
+static Rect GetCoordinateBounds(const int* xs, const int* ys, size_t count, Rect bounds) {
+    for (size_t i = 0; i < count; i++) {
+        bounds.left = std::min(bounds.left, xs[i]);
+        bounds.right = std::max(bounds.right, xs[i]);
+        bounds.top = std::min(bounds.top, ys[i]);
+        bounds.bottom = std::max(bounds.bottom, ys[i]);
+    }
+    return bounds;
+}
+
+void DrawingAlgorithm::DrawLines(HDC hdc, const int* x1, const int* y1, const int* x2, const int* y2, size_t count,
+                                 LineAlgorithm algorithm, COLORREF color, int penWidth, int penStyle) {
+    if (count == 0) return;
+
+    if (algorithm == LineAlgorithm::GDI) {
+        // 每条线段两个顶点，一次 PolyPolyline 画完
+        static thread_local std::vector<POINT> vertices;
+        static thread_local std::vector<DWORD> counts;
+        vertices.resize(count * 2);
+        counts.assign(count, 2);
+        for (size_t i = 0; i < count; i++) {
+            vertices[2 * i].x = x1[i];
+            vertices[2 * i].y = y1[i];
+            vertices[2 * i + 1].x = x2[i];
+            vertices[2 * i + 1].y = y2[i];
+        }
+
+        HPEN hPen = CreatePen(penStyle, penWidth, color);
+        HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
+        PolyPolyline(hdc, vertices.data(), counts.data(), (DWORD)count);
+        SelectObject(hdc, hOldPen);
+        DeleteObject(hPen);
+        return;
+    }
+
+    Rect bounds(x1[0], y1[0], x1[0], y1[0]);
+    bounds = GetCoordinateBounds(x1, y1, count, bounds);
+    bounds = GetCoordinateBounds(x2, y2, count, bounds);
+    HdcRaster raster(hdc, bounds);
+    if (!raster.IsEmpty()) {
+        DrawLines(raster.Target(), x1, y1, x2, y2, count, algorithm, color);
+    }
+}
+
+void DrawingAlgorithm::DrawPolyline(HDC hdc, const int* xs, const int* ys, size_t count, bool closed,
+                                    LineAlgorithm algorithm, COLORREF color, int penWidth, int penStyle) {
+    if (count < 2) return;
+
+    if (algorithm == LineAlgorithm::GDI) {
+        // 闭合时在末尾补上起点，一次 Polyline 画完
+        static thread_local std::vector<POINT> vertices;
+        vertices.resize(closed ? count + 1 : count);
+        for (size_t i = 0; i < count; i++) {
+            vertices[i].x = xs[i];
+            vertices[i].y = ys[i];
+        }
+        if (closed) vertices[count] = vertices[0];
+
+        HPEN hPen = CreatePen(penStyle, penWidth, color);
+        HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
+        ::Polyline(hdc, vertices.data(), (int)vertices.size());
+        SelectObject(hdc, hOldPen);
+        DeleteObject(hPen);
+        return;
+    }
+
+    Rect bounds(xs[0], ys[0], xs[0], ys[0]);
+    HdcRaster raster(hdc, GetCoordinateBounds(xs, ys, count, bounds));
+    if (!raster.IsEmpty()) {
+        DrawPolyline(raster.Target(), xs, ys, count, closed, algorithm, color);
+    }
+}
+
+void DrawingAlgorithm::DrawPolyline(HDC hdc, const std::vector<Point>& points, bool closed,
+                                    LineAlgorithm algorithm, COLORREF color, int penWidth, int penStyle) {
+    // 拆成结构数组（同一线程内复用缓冲区）
+    static thread_local std::vector<int> xs, ys;
+    xs.resize(points.size());
+    ys.resize(points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        xs[i] = points[i].x;
+        ys[i] = points[i].y;
     }
+    DrawPolyline(hdc, xs.data(), ys.data(), points.size(), closed, algorithm, color, penWidth, penStyle);
+}
+#endif
+
+// 光栅目标版本：没有 GDI 可用，GDI 算法按 Bresenham 算法光栅化
+
+void DrawingAlgorithm::DrawLine(RasterTarget& target, int x1, int y1, int x2, int y2, LineAlgorithm algorithm, COLORREF color) {
+    GetLineRasterizer(algorithm)(target, x1, y1, x2, y2, RasterTarget::ToPixel(color));
+}
+
+void DrawingAlgorithm::DrawCircle(RasterTarget& target, int centerX, int centerY, int radius, CircleAlgorithm algorithm, COLORREF color) {
+    uint32_t pixel = RasterTarget::ToPixel(color);
+
+    switch (algorithm) {
     case CircleAlgorithm::Midpoint:
-        DrawCircleMidpoint(hdc, centerX, centerY, radius, color);
+        DrawCircleMidpoint(target, centerX, centerY, radius, pixel);
         break;
+    case CircleAlgorithm::GDI:
     case CircleAlgorithm::Bresenham:
-        DrawCircleBresenham(hdc, centerX, centerY, radius, color);
+        DrawCircleBresenham(target, centerX, centerY, radius, pixel);
         break;
     }
 }
 
-void DrawingAlgorithm::FillPolygon(HDC hdc, const std::vector<Point>& points, FillAlgorithm algorithm, COLORREF color) {
-    if (points.size() < 3) return;
+void DrawingAlgorithm::FillPolygon(RasterTarget& target, const std::vector<Point>& points, FillAlgorithm algorithm, COLORREF color) {
+    static const std::vector<std::vector<Point>> noHoles;
+    FillPolygon(target, points, noHoles, algorithm, color);
+}
+
+void DrawingAlgorithm::FillPolygon(RasterTarget& target, const std::vector<Point>& outer, const std::vector<std::vector<Point>>& holes,
+                                   FillAlgorithm algorithm, COLORREF color) {
+    if (outer.size() < 3) return;
+
+    uint32_t pixel = RasterTarget::ToPixel(color);
 
     switch (algorithm) {
     case FillAlgorithm::ScanLine:
-        FillPolygonScanLine(hdc, points, color);
+        FillPolygonScanLine(target, outer, holes, pixel);
         break;
     case FillAlgorithm::Fence:
-        FillPolygonFence(hdc, points, color);
+        FillPolygonFence(target, outer, holes, pixel);
         break;
     }
 }
 
+void DrawingAlgorithm::DrawLines(RasterTarget& target, const int* x1, const int* y1, const int* x2, const int* y2, size_t count,
+                                 LineAlgorithm algorithm, COLORREF color) {
+    LineRasterizer rasterize = GetLineRasterizer(algorithm);
+    uint32_t pixel = RasterTarget::ToPixel(color);
+    for (size_t i = 0; i < count; i++) {
+        rasterize(target, x1[i], y1[i], x2[i], y2[i], pixel);
+    }
+}
+
+void DrawingAlgorithm::DrawPolyline(RasterTarget& target, const int* xs, const int* ys, size_t count, bool closed,
+                                    LineAlgorithm algorithm, COLORREF color) {
+    if (count < 2) return;
+
+    LineRasterizer rasterize = GetLineRasterizer(algorithm);
+    uint32_t pixel = RasterTarget::ToPixel(color);
+    for (size_t i = 0; i + 1 < count; i++) {
+        rasterize(target, xs[i], ys[i], xs[i + 1], ys[i + 1], pixel);
+    }
+    if (closed) {
+        rasterize(target, xs[count - 1], ys[count - 1], xs[0], ys[0], pixel);
+    }
+}
+
+// 实心圆：按中点画圆法求出每条扫描线的半宽，整行用区间写入
+// 每条扫描线只写一次，因此也适用于半透明混合
+void DrawingAlgorithm::FillCircle(RasterTarget& target, int centerX, int centerY, int radius, COLORREF color) {
+    if (radius < 0) return;
+
+    uint32_t pixel = RasterTarget::ToPixel(color);
+    int x = 0;
+    int y = radius;
+    int d = 1 - radius;
+
+    while (x <= y) {
+        // 扫描线 centerY ± x 的半宽为 y
+        target.FillSpan(centerX - y, centerX + y, centerY + x, pixel);
+        if (x != 0) {
+            target.FillSpan(centerX - y, centerX + y, centerY - x, pixel);
+        }
+
+        if (d < 0) {
+            d += 2 * x + 3;
+        }
+        else {
+            // y 即将减小：扫描线 centerY ± y 的半宽已确定为 x
+            if (x != y) {
+                target.FillSpan(centerX - x, centerX + x, centerY + y, pixel);
+                target.FillSpan(centerX - x, centerX + x, centerY - y, pixel);
+            }
+            d += 2 * (x - y) + 5;
+            y--;
+        }
+        x++;
+    }
+}
+
+Rect DrawingAlgorithm::GetPolygonBounds(const std::vector<Point>& points) {
+    if (points.empty()) return Rect();
+
+    Rect bounds(points[0], points[0]);
+    for (const auto& p : points) {
+        if (p.x < bounds.left) bounds.left = p.x;
+        if (p.x > bounds.right) bounds.right = p.x;
+        if (p.y < bounds.top) bounds.top = p.y;
+        if (p.y > bounds.bottom) bounds.bottom = p.y;
+    }
+    return bounds;
+}
+
+void DrawingAlgorithm::GetCircleOutline(int centerX, int centerY, int radius, double tolerance, std::vector<Point>& out) {
+    const double PI = 3.14159265358979323846;
+    const int MIN_VERTICES = 8;
+    const int MAX_VERTICES = 4096;
+    out.clear();
+    if (radius <= 0) return;
+
+    int n = MAX_VERTICES;
+    if (tolerance >= radius) {
+        n = MIN_VERTICES;
+    } else if (tolerance > 0.0) {
+        n = (int)std::ceil(PI / std::acos(1.0 - tolerance / radius));
+        n = std::max(MIN_VERTICES, std::min(MAX_VERTICES, n));
+    }
+
+    // (x, y) 每次旋转 2π/n：x' = x·cos - y·sin，y' = x·sin + y·cos
+    double step = 2.0 * PI / n;
+    double c = std::cos(step), s = std::sin(step);
+    double x = radius, y = 0.0;
+    out.reserve(n);
+    for (int i = 0; i < n; i++) {
+        out.push_back(Point(centerX + (int)std::lrint(x), centerY + (int)std::lrint(y)));
+        double nx = x * c - y * s;
+        y = x * s + y * c;
+        x = nx;
+    }
+}
+
 // ============ 私有辅助函数实现 ============
 
-void DrawingAlgorithm::SetPixelSafe(HDC hdc, int x, int y, COLORREF color) {
-    SetPixel(hdc, x, y, color);
+DrawingAlgorithm::LineRasterizer DrawingAlgorithm::GetLineRasterizer(LineAlgorithm algorithm) {
+    switch (algorithm) {
+    case LineAlgorithm::Midpoint:
+        return DrawLineMidpoint;
+    case LineAlgorithm::RunSlice:
+        return DrawLineRunSlice;
+    case LineAlgorithm::GDI:
+    case LineAlgorithm::Bresenham:
+    default:
+        return DrawLineBresenham;
+    }
+}
+
+void DrawingAlgorithm::SetPixelSafe(RasterTarget& target, int x, int y, uint32_t color) {
+    target.SetPixel(x, y, color);
 }
+// 中点法与 Bresenham 算法都先把直线归约到一个卦限：沿主方向每步前进一个像素，
+// 判别式 d 初值为 2 * minor - major，每步加 2 * minor，副方向前进时再减 2 * major。
+// 两者唯一的区别是 d == 0（中点恰好落在直线上）时是否前进：
+// Bresenham 算法 d >= 0 时前进，中点法 d > 0 时前进（原中点法判别式取反后即为此形式）。
+// 绘制前先把直线裁剪到目标表面，只遍历可见的那一段，入口处的判别式由闭式公式求出，
+// 因此输出与不裁剪时逐像素相同，而耗时只与可见像素数有关。
+void DrawingAlgorithm::DrawLineMidpoint(RasterTarget& target, int x1, int y1, int x2, int y2, uint32_t color) {
+    // 确保从左到右绘制
+    if (x2 < x1) {
+        DrawLineMidpoint(target, x2, y2, x1, y1, color);
+        return;
+    }
+
+    int first, last;
+    if (!ClipLineSteps(target.Bounds(), x1, y1, x2, y2, true, first, last)) return;
 
-void DrawingAlgorithm::DrawLineMidpoint(HDC hdc, int x1, int y1, int x2, int y2, COLORREF color) {
-    // 处理不同方向的直线
     int dx = x2 - x1;
     int dy = y2 - y1;
-    
+    int sy = dy < 0 ? -1 : 1;
+    bool xMajor = sy * dy <= dx;
+    int major = xMajor ? dx : sy * dy;
+    int minor = xMajor ? sy * dy : dx;
+
+    // 入口像素及其判别式
+    int j = LineMinorOffset(first, major, minor, true);
+    int d = (int)(2LL * minor * (first + 1) - major - 2LL * major * j);
+    int x = xMajor ? x1 + first : x1 + j;
+    int y = xMajor ? y1 + sy * j : y1 + sy * first;
+
+    for (int i = first; i <= last; i++) {
+        SetPixelSafe(target, x, y, color);
+        if (d > 0) {
+            if (xMajor) y += sy; else x++;
+            d += 2 * (minor - major);
+        } else {
+            d += 2 * minor;
+        }
+        if (xMajor) x++; else y += sy;
+    }
+}
+
+void DrawingAlgorithm::DrawLineBresenham(RasterTarget& target, int x1, int y1, int x2, int y2, uint32_t color) {
     // 确保从左到右绘制
-    if (dx < 0) {
-        DrawLineMidpoint(hdc, x2, y2, x1, y1, color);
+    if (x2 < x1) {
+        DrawLineBresenham(target, x2, y2, x1, y1, color);
         return;
     }
-    
-    // 斜率 0 < k <= 1 的情况
-    if (dy >= 0 && dy <= dx) {
-        int x, y, d0, d1, d2, a, b;
-        y = y1;
-        a = y1 - y2;          // 直线方程中的a
-        b = x2 - x1;          // 直线方程中的b
-        d0 = 2 * a + b;       // 增量初始值
-        d1 = 2 * a;           // d >= 0 时的增量
-        d2 = 2 * (a + b);     // d < 0 时的增量
-        
-        for (x = x1; x <= x2; x++) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d0 < 0) {
-                y++;
-                d0 += d2;
-            } else {
-                d0 += d1;
-            }
+
+    int first, last;
+    if (!ClipLineSteps(target.Bounds(), x1, y1, x2, y2, false, first, last)) return;
+
+    int dx = x2 - x1;
+    int dy = y2 - y1;
+    int sy = dy < 0 ? -1 : 1;
+    bool xMajor = sy * dy <= dx;
+    int major = xMajor ? dx : sy * dy;
+    int minor = xMajor ? sy * dy : dx;
+
+    // 入口像素及其判别式
+    int j = LineMinorOffset(first, major, minor, false);
+    int d = (int)(2LL * minor * (first + 1) - major - 2LL * major * j);
+    int x = xMajor ? x1 + first : x1 + j;
+    int y = xMajor ? y1 + sy * j : y1 + sy * first;
+
+    for (int i = first; i <= last; i++) {
+        SetPixelSafe(target, x, y, color);
+        if (d >= 0) {
+            if (xMajor) y += sy; else x++;
+            d += 2 * (minor - major);
+        } else {
+            d += 2 * minor;
         }
+        if (xMajor) x++; else y += sy;
     }
-    // 斜率 k > 1 的情况
-    else if (dy > 0 && dy > dx) {
-        int x, y, d0, d1, d2, a, b;
-        x = x1;
-        a = y1 - y2;
-        b = x2 - x1;
-        d0 = a + 2 * b;
-        d1 = 2 * b;
-        d2 = 2 * (a + b);
-        
-        for (y = y1; y <= y2; y++) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d0 > 0) {
-                x++;
-                d0 += d2;
-            } else {
-                d0 += d1;
-            }
-        }
+}
+
+// 第 i 个像素（沿主方向）相对起点在副方向上的偏移
+// 判别式在第 i 步之后的值为 2 * minor * (i + 1) - major - 2 * major * j_i，
+// Bresenham 算法保持它在 [2 * minor - 2 * major, 2 * minor) 内，中点法保持在 (…, …] 内，由此：
+//   Bresenham：j_i = floor((2 * minor * i + major) / (2 * major))
+//   中点法：   j_i = floor((2 * minor * i + major - 1) / (2 * major))
+int DrawingAlgorithm::LineMinorOffset(long long i, int major, int minor, bool strict) {
+    if (major == 0) return 0;
+    long long numerator = 2LL * minor * i + major - (strict ? 1 : 0);
+    return (int)(numerator / (2LL * major));
+}
+
+// 求直线（x1 <= x2）落在 bounds 内的像素在主方向上的下标范围 [first, last]
+// 主方向的范围直接算出；副方向偏移 j_i 随 i 单调不减，用二分查找确定
+bool DrawingAlgorithm::ClipLineSteps(const Rect& bounds, int x1, int y1, int x2, int y2, bool strict, int& first, int& last) {
+    long long dx = (long long)x2 - x1;
+    long long dy = (long long)y2 - y1;
+    int sy = dy < 0 ? -1 : 1;
+    bool xMajor = sy * dy <= dx;
+    int major = (int)(xMajor ? dx : sy * dy);
+    int minor = (int)(xMajor ? sy * dy : dx);
+
+    // 主方向：x 向右走，或 y 按 sy 的方向走
+    long long lo, hi;
+    if (xMajor) {
+        lo = (long long)bounds.left - x1;
+        hi = (long long)bounds.right - x1;
+    } else if (sy > 0) {
+        lo = (long long)bounds.top - y1;
+        hi = (long long)bounds.bottom - y1;
+    } else {
+        lo = (long long)y1 - bounds.bottom;
+        hi = (long long)y1 - bounds.top;
     }
-    // 斜率 -1 <= k < 0 的情况
-    else if (dy < 0 && -dy <= dx) {
-        int x, y, d0, d1, d2, a, b;
-        y = y1;
-        a = y2 - y1;
-        b = x2 - x1;
-        d0 = 2 * a + b;
-        d1 = 2 * a;
-        d2 = 2 * (a + b);
-        
-        for (x = x1; x <= x2; x++) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d0 < 0) {
-                y--;
-                d0 += d2;
-            } else {
-                d0 += d1;
-            }
-        }
+    lo = std::max(lo, 0LL);
+    hi = std::min(hi, (long long)major);
+    if (lo > hi) return false;
+
+    // 副方向：允许的偏移范围 [jLo, jHi]
+    long long jLo, jHi;
+    if (!xMajor) {
+        jLo = (long long)bounds.left - x1;
+        jHi = (long long)bounds.right - x1;
+    } else if (sy > 0) {
+        jLo = (long long)bounds.top - y1;
+        jHi = (long long)bounds.bottom - y1;
+    } else {
+        jLo = (long long)y1 - bounds.bottom;
+        jHi = (long long)y1 - bounds.top;
     }
-    // 斜率 k < -1 的情况
-    else {
-        int x, y, d0, d1, d2, a, b;
-        x = x1;
-        a = y2 - y1;
-        b = x2 - x1;
-        d0 = a + 2 * b;
-        d1 = 2 * b;
-        d2 = 2 * (a + b);
-        
-        for (y = y1; y >= y2; y--) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d0 > 0) {
-                x++;
-                d0 += d2;
-            } else {
-                d0 += d1;
-            }
-        }
+
+    // 第一个 j_i >= jLo 的像素
+    if (LineMinorOffset(hi, major, minor, strict) < jLo) return false;
+    long long a = lo, b = hi;
+    while (a < b) {
+        long long mid = a + (b - a) / 2;
+        if (LineMinorOffset(mid, major, minor, strict) >= jLo) b = mid; else a = mid + 1;
+    }
+    lo = a;
+
+    // 最后一个 j_i <= jHi 的像素
+    if (LineMinorOffset(lo, major, minor, strict) > jHi) return false;
+    a = lo;
+    b = hi;
+    while (a < b) {
+        long long mid = a + (b - a + 1) / 2;
+        if (LineMinorOffset(mid, major, minor, strict) <= jHi) a = mid; else b = mid - 1;
     }
+
+    first = (int)lo;
+    last = (int)a;
+    return true;
 }
 
-void DrawingAlgorithm::DrawLineBresenham(HDC hdc, int x1, int y1, int x2, int y2, COLORREF color) {
-    // 处理不同方向的直线
+// 游程切片：Bresenham 在主方向上每走一步判断一次副方向是否前进，
+// 这里改为直接求出副坐标不变的一整段（游程）的长度，用一次区间写入输出。
+// 判别式 d 的初值与增量与 DrawLineBresenham 完全相同，因此输出逐像素一致。
+void DrawingAlgorithm::DrawLineRunSlice(RasterTarget& target, int x1, int y1, int x2, int y2, uint32_t color) {
+    // 与 DrawLineBresenham 一样先保证从左到右
+    if (x2 < x1) {
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+
     int dx = x2 - x1;
     int dy = y2 - y1;
-    
-    // 确保从左到右绘制
-    if (dx < 0) {
-        DrawLineBresenham(hdc, x2, y2, x1, y1, color);
-        return;
-    }
-    
-    // 斜率 0 < k <= 1 的情况
-    if (dy >= 0 && dy <= dx) {
-        int x, y, d;
-        y = y1;
-        d = 2 * dy - dx;      // 增量d的初始值
-        
-        for (x = x1; x <= x2; x++) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d < 0) {
-                d += 2 * dy;
-            } else {
-                y++;
-                d += 2 * dy - 2 * dx;
-            }
+    int sy = dy < 0 ? -1 : 1;
+    bool xMajor = sy * dy <= dx;
+    int major = xMajor ? dx : sy * dy;   // 主方向的跨度
+    int minor = xMajor ? sy * dy : dx;   // 副方向的跨度
+
+    // 水平/竖直线只有一段
+    if (minor == 0) {
+        if (xMajor) {
+            target.FillSpan(x1, x2, y1, color);
+        } else {
+            target.FillVerticalSpan(x1, y1, y2, color);
         }
+        return;
     }
-    // 斜率 k > 1 的情况
-    else if (dy > 0 && dy > dx) {
-        int x, y, d;
-        x = x1;
-        d = 2 * dx - dy;
-        
-        for (y = y1; y <= y2; y++) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d < 0) {
-                d += 2 * dx;
-            } else {
-                x++;
-                d += 2 * dx - 2 * dy;
-            }
-        }
+
+    // 游程平均长度不足 4 个像素时按段输出没有收益，逐像素画（结果相同）
+    if (major < 4 * minor) {
+        DrawLineBresenham(target, x1, y1, x2, y2, color);
+        return;
     }
-    // 斜率 -1 <= k < 0 的情况
-    else if (dy < 0 && -dy <= dx) {
-        int x, y, d;
-        y = y1;
-        d = 2 * (-dy) - dx;
-        
-        for (x = x1; x <= x2; x++) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d < 0) {
-                d += 2 * (-dy);
+
+    // 只遍历落在表面内的那一段，入口处的副方向偏移和判别式与 DrawLineBresenham 相同
+    int first, last;
+    if (!ClipLineSteps(target.Bounds(), x1, y1, x2, y2, false, first, last)) return;
+    int j = LineMinorOffset(first, major, minor, false);
+    int x = xMajor ? x1 + first : x1 + j;
+    int y = xMajor ? y1 + sy * j : y1 + sy * first;
+
+    // 游程长度 k 是满足 d + 2 * minor * (k - 1) >= 0 的最小正整数，
+    // 此后 d 变为 d + 2 * minor * k - 2 * major。
+    // 完整游程的长度都不小于 major / minor - 1，从这个下界开始逐个试探，
+    // 每段只需常数次比较；入口所在的第一段可能不完整，用一次除法求出。
+    int step = 2 * minor;
+    int d = (int)(2LL * minor * (first + 1) - major - 2LL * major * j);
+    int minRun = std::max(1, major / minor - 1);
+    int run = d >= 0 ? 1 : 1 + (-d + step - 1) / step;
+
+    // 裁剪后所有像素都在表面内，直接按指针写
+    uint32_t* p = target.Row(y) + (x - target.OriginX());
+    ptrdiff_t rowStep = (ptrdiff_t)sy * target.Stride();
+    int remaining = last - first + 1;
+    while (remaining > 0) {
+        run = std::min(run, remaining);
+        if (xMajor) {
+            // 短游程直接写，长游程交给 SIMD 区间写入
+            if (run <= 8) {
+                for (int i = 0; i < run; i++) p[i] = color;
             } else {
-                y--;
-                d += 2 * (-dy) - 2 * dx;
+                SpanWriter::Fill(p, run, color);
             }
+            p += run + rowStep;
+        } else {
+            for (int i = 0; i < run; i++, p += rowStep) *p = color;
+            p++;
         }
-    }
-    // 斜率 k < -1 的情况
-    else {
-        int x, y, d;
-        x = x1;
-        d = 2 * dx - (-dy);
-        
-        for (y = y1; y >= y2; y--) {
-            SetPixelSafe(hdc, x, y, color);
-            if (d < 0) {
-                d += 2 * dx;
-            } else {
-                x++;
-                d += 2 * dx - 2 * (-dy);
-            }
+        remaining -= run;
+        d += step * run - 2 * major;
+
+        run = minRun;
+        while (d + step * (run - 1) < 0) {
+            run++;
         }
     }
 }
 
-void DrawingAlgorithm::DrawCircleMidpoint(HDC hdc, int centerX, int centerY, int radius, COLORREF color) {
+void DrawingAlgorithm::DrawCircleMidpoint(RasterTarget& target, int centerX, int centerY, int radius, uint32_t color) {
+    // 跳过完全落在表面外的八分圆弧，全部在外时直接返回
+    unsigned octants = GetVisibleOctants(target.Bounds(), centerX, centerY, radius);
+    if (octants == 0) return;
+
     int x = 0;
     int y = radius;
     int d = 1 - radius;
 
-    DrawCirclePoints(hdc, centerX, centerY, x, y, color);
+    DrawCirclePoints(target, centerX, centerY, x, y, color, octants);
 
     while (x < y) {
         if (d < 0) {
@@ -249,16 +558,19 @@ void DrawingAlgorithm::DrawCircleMidpoint(HDC hdc, int centerX, int centerY, int
             y--;
         }
         x++;
-        DrawCirclePoints(hdc, centerX, centerY, x, y, color);
+        DrawCirclePoints(target, centerX, centerY, x, y, color, octants);
     }
 }
 
-void DrawingAlgorithm::DrawCircleBresenham(HDC hdc, int centerX, int centerY, int radius, COLORREF color) {
+void DrawingAlgorithm::DrawCircleBresenham(RasterTarget& target, int centerX, int centerY, int radius, uint32_t color) {
+    unsigned octants = GetVisibleOctants(target.Bounds(), centerX, centerY, radius);
+    if (octants == 0) return;
+
     int x = 0;
     int y = radius;
     int d = 3 - 2 * radius;
 
-    DrawCirclePoints(hdc, centerX, centerY, x, y, color);
+    DrawCirclePoints(target, centerX, centerY, x, y, color, octants);
 
     while (x <= y) {
         if (d < 0) {
@@ -269,118 +581,154 @@ void DrawingAlgorithm::DrawCircleBresenham(HDC hdc, int centerX, int centerY, in
             y--;
         }
         x++;
-        DrawCirclePoints(hdc, centerX, centerY, x, y, color);
+        DrawCirclePoints(target, centerX, centerY, x, y, color, octants);
     }
 }
 
-void DrawingAlgorithm::DrawCirclePoints(HDC hdc, int centerX, int centerY, int x, int y, COLORREF color) {
-    SetPixelSafe(hdc, centerX + x, centerY + y, color);
-    SetPixelSafe(hdc, centerX - x, centerY + y, color);
-    SetPixelSafe(hdc, centerX + x, centerY - y, color);
-    SetPixelSafe(hdc, centerX - x, centerY - y, color);
-    SetPixelSafe(hdc, centerX + y, centerY + x, color);
-    SetPixelSafe(hdc, centerX - y, centerY + x, color);
-    SetPixelSafe(hdc, centerX + y, centerY - x, color);
-    SetPixelSafe(hdc, centerX - y, centerY - x, color);
+void DrawingAlgorithm::DrawCirclePoints(RasterTarget& target, int centerX, int centerY, int x, int y, uint32_t color, unsigned octants) {
+    if (octants & 0x01) SetPixelSafe(target, centerX + x, centerY + y, color);
+    if (octants & 0x02) SetPixelSafe(target, centerX - x, centerY + y, color);
+    if (octants & 0x04) SetPixelSafe(target, centerX + x, centerY - y, color);
+    if (octants & 0x08) SetPixelSafe(target, centerX - x, centerY - y, color);
+    if (octants & 0x10) SetPixelSafe(target, centerX + y, centerY + x, color);
+    if (octants & 0x20) SetPixelSafe(target, centerX - y, centerY + x, color);
+    if (octants & 0x40) SetPixelSafe(target, centerX + y, centerY - x, color);
+    if (octants & 0x80) SetPixelSafe(target, centerX - y, centerY - x, color);
 }
 
-void DrawingAlgorithm::FillPolygonScanLine(HDC hdc, const std::vector<Point>& points, COLORREF color) {
-    if (points.size() < 3) return;
+// 画圆时 (x, y) 从 (0, r) 走到 x ≈ y 处，x 不超过 r/√2 + 1，y 不小于 r/√2 - 1，
+// 每个八分圆弧都落在一个已知的矩形内；矩形与表面不相交的圆弧不必绘制。
+// 返回值第 k 位对应 DrawCirclePoints 中的第 k 个对称点。
+unsigned DrawingAlgorithm::GetVisibleOctants(const Rect& bounds, int centerX, int centerY, int radius) {
+    long long r = radius;
+    long long h = (long long)(radius * 0.70710678118654752);   // r/√2
+    long long cx = centerX;
+    long long cy = centerY;
 
-    // 找到多边形的上下边界
-    int minY = points[0].y, maxY = points[0].y;
-    for (const auto& p : points) {
-        if (p.y < minY) minY = p.y;
-        if (p.y > maxY) maxY = p.y;
-    }
+    // 弧上点 (cx ± a, cy ± b) 中 a 和 b 的范围：近端 [0, h + 2]，远端 [h - 2, r]
+    auto overlaps = [&](long long sx, long long ax1, long long ax2, long long sy, long long by1, long long by2) {
+        long long left = sx > 0 ? cx + ax1 : cx - ax2;
+        long long right = sx > 0 ? cx + ax2 : cx - ax1;
+        long long top = sy > 0 ? cy + by1 : cy - by2;
+        long long bottom = sy > 0 ? cy + by2 : cy - by1;
+        return left <= bounds.right && right >= bounds.left && top <= bounds.bottom && bottom >= bounds.top;
+    };
 
-    // 对每条扫描线
-    for (int y = minY; y <= maxY; y++) {
-        std::vector<int> intersections;
+    long long nearLo = 0, nearHi = std::min(h + 2, r);
+    long long farLo = std::max(h - 2, 0LL), farHi = r;
+    unsigned octants = 0;
+    if (overlaps( 1, nearLo, nearHi,  1, farLo, farHi)) octants |= 0x01;
+    if (overlaps(-1, nearLo, nearHi,  1, farLo, farHi)) octants |= 0x02;
+    if (overlaps( 1, nearLo, nearHi, -1, farLo, farHi)) octants |= 0x04;
+    if (overlaps(-1, nearLo, nearHi, -1, farLo, farHi)) octants |= 0x08;
+    if (overlaps( 1, farLo, farHi,  1, nearLo, nearHi)) octants |= 0x10;
+    if (overlaps(-1, farLo, farHi,  1, nearLo, nearHi)) octants |= 0x20;
+    if (overlaps( 1, farLo, farHi, -1, nearLo, nearHi)) octants |= 0x40;
+    if (overlaps(-1, farLo, farHi, -1, nearLo, nearHi)) octants |= 0x80;
+    return octants;
+}
 
-        // 找到与扫描线的所有交点
-        size_t n = points.size();
-        for (size_t i = 0; i < n; i++) {
-            Point p1 = points[i];
-            Point p2 = points[(i + 1) % n];
+void DrawingAlgorithm::FillPolygonScanLine(RasterTarget& target, const std::vector<Point>& outer,
+                                           const std::vector<std::vector<Point>>& holes, uint32_t color) {
+    if (outer.size() < 3) return;
 
-            if (p1.y > p2.y) std::swap(p1, p2);
+    // 有序边表 / 活动边表在同一线程的多次填充之间复用，避免逐行分配内存
+    static thread_local ActiveEdgeTable edgeTable;
+    edgeTable.Build(outer, holes);
 
-            if (y >= p1.y && y < p2.y) {//顶点重复
-                if (p2.y != p1.y) {//水平边
-                    int x = p1.x + (y - p1.y) * (p2.x - p1.x) / (p2.y - p1.y);
-                    intersections.push_back(x);
-                }
-            }
-        }
+    // 只扫描落在目标表面内的扫描线
+    Rect bounds = target.Bounds();
+    edgeTable.Scan(bounds.top, bounds.bottom, [&](int x1, int x2, int y) {
+        target.FillSpan(x1, x2, y, color);
+    });
 
-        // 对交点排序
-        std::sort(intersections.begin(), intersections.end());
+    DrawRingOutlines(target, outer, holes);
+}
 
-        // 填充交点之间的像素
-        for (size_t i = 0; i + 1 < intersections.size(); i += 2) {
-            for (int x = intersections[i]; x <= intersections[i + 1]; x++) {
-                SetPixelSafe(hdc, x, y, color);
-            }
-        }
-    }
+void DrawingAlgorithm::FillPolygonFence(RasterTarget& target, const std::vector<Point>& outer,
+                                        const std::vector<std::vector<Point>>& holes, uint32_t color) {
+    if (outer.size() < 3) return;
 
-    // 绘制边界
-    size_t n = points.size();
-    for (size_t i = 0; i < n; i++) {
-        DrawLineBresenham(hdc, points[i].x, points[i].y,
-            points[(i + 1) % n].x, points[(i + 1) % n].y, RGB(0, 0, 0));
-    }
-}
+    // 找到多边形的边界（洞位于外环之内），并裁剪到目标表面
+    Rect bounds = GetPolygonBounds(outer);
+    Rect surface = target.Bounds();
+    int left = std::max(bounds.left, surface.left);
+    int right = std::min(bounds.right, surface.right);
+    int top = std::max(bounds.top, surface.top);
+    int bottom = std::min(bounds.bottom, surface.bottom);
 
-void DrawingAlgorithm::FillPolygonFence(HDC hdc, const std::vector<Point>& points, COLORREF color) {
-    if (points.size() < 3) return;
+    if (left <= right && top <= bottom) {
+        // 1 位/像素掩码在同一线程的多次填充之间复用
+        static thread_local FenceMask mask;
+        mask.Reset(left, top, right - left + 1, bottom - top + 1);
 
-    // 找到多边形的边界
-    int minX = points[0].x, maxX = points[0].x;
-    int minY = points[0].y, maxY = points[0].y;
-    for (const auto& p : points) {
-        if (p.x < minX) minX = p.x;
-        if (p.x > maxX) maxX = p.x;
-        if (p.y < minY) minY = p.y;
-        if (p.y > maxY) maxY = p.y;
-    }
+        // 栅栏取包围盒的竖直中线，缩短每次求补的长度
+        int fence = (left + right + 1) / 2;
 
-    // 点在多边形内部的判断(射线法)
-    auto isInside = [&](int x, int y) -> bool {
-        int crossings = 0;
-        size_t n = points.size();
-        for (size_t i = 0; i < n; i++) {
-            Point p1 = points[i];
-            Point p2 = points[(i + 1) % n];
+        // 对每个环的每条边：在它经过的每条扫描线上，把交点与栅栏之间的像素求补
+        // 交点 xi 之左的像素 (x < xi) 被计数一次，与射线法判断内外一致；洞内的像素被求补两次，不填充
+        for (size_t ring = 0; ring <= holes.size(); ring++) {
+            const std::vector<Point>& points = ring == 0 ? outer : holes[ring - 1];
+            if (points.size() < 3) continue;
+            size_t n = points.size();
+            for (size_t i = 0; i < n; i++) {
+                Point p1 = points[i];
+                Point p2 = points[(i + 1) % n];
+                if (p1.y == p2.y) continue;      // 水平边不产生交点
+                if (p1.y > p2.y) std::swap(p1, p2);
 
-            if ((p1.y <= y && p2.y > y) || (p1.y > y && p2.y <= y)) {
-                double vt = (double)(y - p1.y) / (p2.y - p1.y);
-                if (x < p1.x + vt * (p2.x - p1.x)) {
-                    crossings++;
-                }
-            }
-        }
-        return (crossings % 2) == 1;
-    };
+                // 边覆盖扫描线 [p1.y, p2.y)，只处理落在掩码内的部分
+                int yStart = std::max(p1.y, top);
+                int yEnd = std::min(p2.y - 1, bottom);
+                if (yStart > yEnd) continue;
+
+                // 交点 xi = p1.x + k * dx / dy，以 p1.x + q + r / dy 的形式逐行递推，
+                // 像素 x 位于交点左侧当且仅当 x < ceil(xi)
+                int64_t dx = p2.x - p1.x;
+                int64_t dy = p2.y - p1.y;
+                int64_t stepQ = dx >= 0 ? dx / dy : -((-dx + dy - 1) / dy);   // floor(dx / dy)
+                int64_t stepR = dx - stepQ * dy;                                // [0, dy)
+                int64_t num = (int64_t)(yStart - p1.y) * dx;
+                int64_t q = num >= 0 ? num / dy : -((-num + dy - 1) / dy);
+                int64_t r = num - q * dy;
 
-    // 使用栅栏填充(隔行扫描)
-    for (int y = minY; y <= maxY; y += 2) {
-        for (int x = minX; x <= maxX; x++) {
-            if (isInside(x, y)) {
-                SetPixelSafe(hdc, x, y, color);
-                if (y + 1 <= maxY) {
-                    SetPixelSafe(hdc, x, y + 1, color);
+                for (int y = yStart; y <= yEnd; y++) {
+                    int64_t c = p1.x + q + (r > 0 ? 1 : 0);
+                    c = std::max<int64_t>(left, std::min<int64_t>(right + 1, c));
+                    if (c < fence) {
+                        mask.XorSpan(y, (int)c, fence);
+                    } else {
+                        mask.XorSpan(y, fence, (int)c);
+                    }
+
+                    q += stepQ;
+                    r += stepR;
+                    if (r >= dy) {
+                        r -= dy;
+                        q++;
+                    }
                 }
             }
         }
+
+        // 一次扫描掩码，把内部像素按区间写入目标
+        mask.ForEachSpan([&](int x1, int x2, int y) {
+            target.FillSpan(x1, x2, y, color);
+        });
     }
 
-    // 绘制边界
-    size_t n = points.size();
-    for (size_t i = 0; i < n; i++) {
-        DrawLineBresenham(hdc, points[i].x, points[i].y,
-            points[(i + 1) % n].x, points[(i + 1) % n].y, RGB(0, 0, 0));
+    DrawRingOutlines(target, outer, holes);
+}
+
+void DrawingAlgorithm::DrawRingOutlines(RasterTarget& target, const std::vector<Point>& outer,
+                                        const std::vector<std::vector<Point>>& holes) {
+    for (size_t ring = 0; ring <= holes.size(); ring++) {
+        const std::vector<Point>& points = ring == 0 ? outer : holes[ring - 1];
+        size_t n = points.size();
+        for (size_t i = 0; i < n; i++) {
+            DrawLineBresenham(target, points[i].x, points[i].y,
+                points[(i + 1) % n].x, points[(i + 1) % n].y, 0x000000);
+        }
     }
 }
 
@@ -564,15 +912,22 @@ std::vector<std::vector<Point>> DrawingAlgorithm::ClipPolygon_WeilerAtherton(con
                                                                                const std::vector<Point>& inVerts) {
     if (inVerts.size() < 3) return {};
     
-    // 将矩形裁剪窗口转换为多边形顶点序列
-    std::vector<Point> clipPoly;
-    clipPoly.push_back(Point(clipRect.left, clipRect.top));
-    clipPoly.push_back(Point(clipRect.right, clipRect.top));
-    clipPoly.push_back(Point(clipRect.right, clipRect.bottom));
-    clipPoly.push_back(Point(clipRect.left, clipRect.bottom));
-    
-    // 调用 Weiler-Atherton 算法，返回所有裁剪结果
-    return WeilerAtherton::clip(inVerts, clipPoly);
+    // 矩形窗口走 Weiler-Atherton 的矩形快速路径，返回所有裁剪结果
+    return WeilerAtherton::clip(inVerts, clipRect);
+}
+
+// 多边形布尔运算：扫描线引擎的工作数组属于当前线程，在多次调用间复用
+std::vector<std::vector<Point>> DrawingAlgorithm::BooleanPolygons(const std::vector<Point>& subject, 
+                                                                  const std::vector<Point>& clip, BooleanOp op) {
+    return BooleanPolygons(PolygonBoolean::Rings{ subject }, PolygonBoolean::Rings{ clip }, op);
+}
+
+std::vector<std::vector<Point>> DrawingAlgorithm::BooleanPolygons(const std::vector<std::vector<Point>>& subject,
+                                                                  const std::vector<std::vector<Point>>& clip, BooleanOp op) {
+    static thread_local PolygonBoolean engine;
+    std::vector<std::vector<Point>> result;
+    engine.Compute(subject, clip, op, result);
+    return result;
 }
 
 // ==================== 裁剪算法辅助函数实现 ====================
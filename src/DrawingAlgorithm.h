@@ -1,16 +1,20 @@
 #pragma once
-#include <windows.h>
 #include <vector>
 #include <algorithm>
 #include <cmath>
 #include "Point.h"
+#include "RasterTarget.h"
+#include "EdgeTable.h"
+#include "FenceMask.h"
 #include "WeilerAtherton.h"
+#include "PolygonBoolean.h"
 
 // 绘制算法枚举
 enum class LineAlgorithm {
     GDI,          // 使用GDI直接绘制
     Midpoint,     // 中点法
-    Bresenham     // Bresenham算法
+    Bresenham,    // Bresenham算法
+    RunSlice      // 游程切片 Bresenham（按整段水平/竖直像素输出，结果与 Bresenham 相同）
 };
 
 enum class CircleAlgorithm {
@@ -38,6 +42,7 @@ enum class PolygonClipAlgorithm {
 // 绘制算法类
 class DrawingAlgorithm {
 public:
+#ifdef _WIN32
     // 直线绘制算法
     static void DrawLine(HDC hdc, int x1, int y1, int x2, int y2, LineAlgorithm algorithm, COLORREF color = RGB(0, 0, 0));
     
@@ -46,6 +51,43 @@ public:
     
     // 填充算法
     static void FillPolygon(HDC hdc, const std::vector<Point>& points, FillAlgorithm algorithm, COLORREF color = RGB(100, 100, 255));
+    // 带洞的多边形：外环与各个洞按奇偶规则填充，洞内不填充，所有环都绘制边界
+    static void FillPolygon(HDC hdc, const std::vector<Point>& outer, const std::vector<std::vector<Point>>& holes,
+                            FillAlgorithm algorithm, COLORREF color = RGB(100, 100, 255));
+    
+    // 实心圆（控制点等标记）
+    static void FillCircle(HDC hdc, int centerX, int centerY, int radius, COLORREF color);
+    
+    // 批量绘制直线：端点按结构数组（SoA）连续存放，第 i 条线段为 (x1[i], y1[i]) - (x2[i], y2[i])
+    // 画笔只创建一次；GDI 算法用一次 PolyPolyline 画完，软件算法共用一个光栅目标
+    // penWidth / penStyle 只对 GDI 算法有效，软件算法总是画 1 像素实线
+    static void DrawLines(HDC hdc, const int* x1, const int* y1, const int* x2, const int* y2, size_t count,
+                          LineAlgorithm algorithm, COLORREF color = RGB(0, 0, 0), int penWidth = 1, int penStyle = PS_SOLID);
+    
+    // 批量绘制折线：依次连接 (xs[i], ys[i])，closed 为 true 时再连回起点；GDI 算法用一次 Polyline 画完
+    static void DrawPolyline(HDC hdc, const int* xs, const int* ys, size_t count, bool closed,
+                             LineAlgorithm algorithm, COLORREF color = RGB(0, 0, 0), int penWidth = 1, int penStyle = PS_SOLID);
+    static void DrawPolyline(HDC hdc, const std::vector<Point>& points, bool closed,
+                             LineAlgorithm algorithm, COLORREF color = RGB(0, 0, 0), int penWidth = 1, int penStyle = PS_SOLID);
+#endif
+
+    // 光栅目标版本：直接写入内存表面，不依赖 GDI（可在无窗口环境下使用）
+    static void DrawLine(RasterTarget& target, int x1, int y1, int x2, int y2, LineAlgorithm algorithm, COLORREF color = RGB(0, 0, 0));
+    static void DrawCircle(RasterTarget& target, int centerX, int centerY, int radius, CircleAlgorithm algorithm, COLORREF color = RGB(0, 0, 0));
+    static void FillPolygon(RasterTarget& target, const std::vector<Point>& points, FillAlgorithm algorithm, COLORREF color = RGB(100, 100, 255));
+    static void FillPolygon(RasterTarget& target, const std::vector<Point>& outer, const std::vector<std::vector<Point>>& holes,
+                            FillAlgorithm algorithm, COLORREF color = RGB(100, 100, 255));
+    static void FillCircle(RasterTarget& target, int centerX, int centerY, int radius, COLORREF color);
+    static void DrawLines(RasterTarget& target, const int* x1, const int* y1, const int* x2, const int* y2, size_t count,
+                          LineAlgorithm algorithm, COLORREF color = RGB(0, 0, 0));
+    static void DrawPolyline(RasterTarget& target, const int* xs, const int* ys, size_t count, bool closed,
+                             LineAlgorithm algorithm, COLORREF color = RGB(0, 0, 0));
+    
+    // 计算多边形顶点的包围盒（包含边界）
+    static Rect GetPolygonBounds(const std::vector<Point>& points);
+    // 把圆近似为内接正多边形，顶点数由容差决定：边的中点到圆周的距离 r·(1 - cos(π/n)) 不超过 tolerance 像素
+    // （小圆顶点少，大圆顶点多）；顶点用旋转递推生成，整个轮廓只计算一次三角函数
+    static void GetCircleOutline(int centerX, int centerY, int radius, double tolerance, std::vector<Point>& out);
 
     // ==================== 实验二：裁剪算法 ====================
     
@@ -68,31 +110,61 @@ public:
     // 返回值：裁剪后的多边形列表（可能有多个）
     // 该算法支持返回多个裁剪结果
     static std::vector<std::vector<Point>> ClipPolygon_WeilerAtherton(const Rect& clipRect, const std::vector<Point>& inVerts);
+    
+    // 多边形布尔运算（交、并、差、异或），两个多边形都可以是凹的或自交的（按奇偶规则确定区域）
+    // 返回值：结果的各个环，区域在前进方向左侧，外环与洞的方向相反
+    static std::vector<std::vector<Point>> BooleanPolygons(const std::vector<Point>& subject, const std::vector<Point>& clip, BooleanOp op);
+    // 由若干环组成的多边形（如带洞的布尔运算结果）之间的布尔运算
+    static std::vector<std::vector<Point>> BooleanPolygons(const std::vector<std::vector<Point>>& subject,
+                                                           const std::vector<std::vector<Point>>& clip, BooleanOp op);
 
 private:
+    // 软件直线算法的统一签名，批量绘制时只选择一次
+    typedef void (*LineRasterizer)(RasterTarget& target, int x1, int y1, int x2, int y2, uint32_t color);
+    static LineRasterizer GetLineRasterizer(LineAlgorithm algorithm);
+    
     // 画点的辅助函数
-    static void SetPixelSafe(HDC hdc, int x, int y, COLORREF color);
+    static void SetPixelSafe(RasterTarget& target, int x, int y, uint32_t color);
     
     // 中点法绘制直线
-    static void DrawLineMidpoint(HDC hdc, int x1, int y1, int x2, int y2, COLORREF color);
+    static void DrawLineMidpoint(RasterTarget& target, int x1, int y1, int x2, int y2, uint32_t color);
     
     // Bresenham算法绘制直线
-    static void DrawLineBresenham(HDC hdc, int x1, int y1, int x2, int y2, COLORREF color);
+    static void DrawLineBresenham(RasterTarget& target, int x1, int y1, int x2, int y2, uint32_t color);
+    
+    // 游程切片算法绘制直线：一次求出一整段同行（或同列）像素的长度
+    static void DrawLineRunSlice(RasterTarget& target, int x1, int y1, int x2, int y2, uint32_t color);
+    
+    // 直线预裁剪：求 (x1 <= x2) 的直线落在 bounds 内的像素在主方向上的下标范围
+    // strict 为 true 表示中点法（判别式为 0 时副方向不前进），false 表示 Bresenham 算法
+    static bool ClipLineSteps(const Rect& bounds, int x1, int y1, int x2, int y2, bool strict, int& first, int& last);
+    
+    // 主方向第 i 个像素在副方向上相对起点的偏移（闭式公式）
+    static int LineMinorOffset(long long i, int major, int minor, bool strict);
     
     // 中点法绘制圆
-    static void DrawCircleMidpoint(HDC hdc, int centerX, int centerY, int radius, COLORREF color);
+    static void DrawCircleMidpoint(RasterTarget& target, int centerX, int centerY, int radius, uint32_t color);
     
     // Bresenham算法绘制圆
-    static void DrawCircleBresenham(HDC hdc, int centerX, int centerY, int radius, COLORREF color);
+    static void DrawCircleBresenham(RasterTarget& target, int centerX, int centerY, int radius, uint32_t color);
+    
+    // 绘制圆的八个对称点（octants 的第 k 位为 0 时跳过第 k 个点）
+    static void DrawCirclePoints(RasterTarget& target, int centerX, int centerY, int x, int y, uint32_t color, unsigned octants = 0xFF);
+    
+    // 与表面相交的八分圆弧（位掩码），用于跳过完全不可见的圆弧
+    static unsigned GetVisibleOctants(const Rect& bounds, int centerX, int centerY, int radius);
     
-    // 绘制圆的八个对称点
-    static void DrawCirclePoints(HDC hdc, int centerX, int centerY, int x, int y, COLORREF color);
+    // 扫描线填充算法（基于有序边表 / 活动边表），洞的边与外环的边一起进入边表
+    static void FillPolygonScanLine(RasterTarget& target, const std::vector<Point>& outer,
+                                    const std::vector<std::vector<Point>>& holes, uint32_t color);
     
-    // 扫描线填充算法
-    static void FillPolygonScanLine(HDC hdc, const std::vector<Point>& points, COLORREF color);
+    // 栅栏填充算法（边与栅栏之间求补，结果记录在位掩码中），洞的边同样求补
+    static void FillPolygonFence(RasterTarget& target, const std::vector<Point>& outer,
+                                 const std::vector<std::vector<Point>>& holes, uint32_t color);
     
-    // 栅栏填充算法
-    static void FillPolygonFence(HDC hdc, const std::vector<Point>& points, COLORREF color);
+    // 绘制外环和各个洞的边界
+    static void DrawRingOutlines(RasterTarget& target, const std::vector<Point>& outer,
+                                 const std::vector<std::vector<Point>>& holes);
     
     // ==================== 裁剪算法辅助函数 ====================
     
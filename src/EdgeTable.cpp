@@ -0,0 +1,52 @@
+#include "EdgeTable.h"
+#include <algorithm>
+
+void ActiveEdgeTable::Build(const std::vector<Point>& points) {
+    Build(points, std::vector<std::vector<Point>>());
+}
+
+void ActiveEdgeTable::Build(const std::vector<Point>& outer, const std::vector<std::vector<Point>>& holes) {
+    edges.clear();
+    active.clear();
+    minY = maxY = 0;
+    AddRing(outer);
+    for (const auto& hole : holes) AddRing(hole);
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const Edge& a, const Edge& b) { return a.yTop < b.yTop; });
+}
+
+void ActiveEdgeTable::AddRing(const std::vector<Point>& points) {
+    if (points.size() < 3) return;
+
+    if (edges.empty()) minY = maxY = points[0].y;
+    size_t n = points.size();
+    for (size_t i = 0; i < n; i++) {
+        Point p1 = points[i];
+        Point p2 = points[(i + 1) % n];
+        if (p1.y < minY) minY = p1.y;
+        if (p1.y > maxY) maxY = p1.y;
+
+        if (p1.y == p2.y) continue;    // 水平边不产生交点
+        if (p1.y > p2.y) std::swap(p1, p2);
+
+        Edge e;
+        e.yTop = p1.y;
+        e.yBottom = p2.y;
+        e.xTop = p1.x;
+        e.dy = p2.y - p1.y;
+        int dx = p2.x - p1.x;
+        e.dir = dx < 0 ? -1 : 1;
+        e.dxAbs = dx < 0 ? -dx : dx;
+        e.step = e.dir * (e.dxAbs / e.dy);
+        e.errStep = e.dxAbs % e.dy;
+        e.x = e.xTop;
+        e.err = 0;
+        edges.push_back(e);
+    }
+}
+
+void ActiveEdgeTable::Seek(Edge& e, int y) {
+    int64_t num = (int64_t)(y - e.yTop) * e.dxAbs;
+    e.x = e.xTop + e.dir * (int)(num / e.dy);
+    e.err = (int)(num % e.dy);
+}
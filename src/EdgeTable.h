@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Point.h"
+
+// 扫描线填充引擎：有序边表（ET）+ 活动边表（AET）
+// 每条边只在进入扫描线时初始化一次，之后逐行用增量更新交点 x：
+// x 以 "整数部分 + 分子/dy" 的定点形式保存，每行加上 dx/dy 的商和余数，
+// 结果与 x = x1 + (y - y1) * dx / dy（向零截断）逐行精确一致，没有除法也没有累积误差。
+// 总代价与 边数 + 区间数 成正比，边表和活动边表的内存在多次调用之间复用。
+class ActiveEdgeTable {
+public:
+    // 由多边形顶点建立有序边表（水平边被忽略，每条边覆盖 [上端点y, 下端点y)）
+    void Build(const std::vector<Point>& points);
+    // 由外环和若干洞共同建立边表：交点成对填充即奇偶规则，洞内不填充
+    void Build(const std::vector<Point>& outer, const std::vector<std::vector<Point>>& holes);
+
+    // 多边形覆盖的扫描线范围 [MinY, MaxY]
+    int MinY() const { return minY; }
+    int MaxY() const { return maxY; }
+    bool IsEmpty() const { return edges.empty(); }
+
+    // 按从上到下的顺序扫描 [yFrom, yTo] 内的扫描线，
+    // 对每对交点调用 emit(x1, x2, y)（两端都包含，x1 <= x2）
+    template <typename SpanFunc>
+    void Scan(int yFrom, int yTo, SpanFunc emit);
+
+private:
+    struct Edge {
+        int yTop;        // 边覆盖的第一条扫描线
+        int yBottom;     // 边覆盖的最后一条扫描线之后一行
+        int xTop;        // yTop 处的 x
+        int dir;         // x 的变化方向（+1 / -1）
+        int dxAbs;       // |dx|
+        int dy;          // dy（> 0）
+        int step;        // 每行 x 的整数增量 = dir * (|dx| / dy)
+        int errStep;     // 每行分子的增量 = |dx| % dy
+        int x;           // 当前扫描线的交点
+        int err;         // 当前的分子余量，范围 [0, dy)
+    };
+
+    // 加入一个环的边（少于 3 个顶点的环被忽略）
+    void AddRing(const std::vector<Point>& points);
+    // 把边定位到第 y 行（y >= yTop）
+    static void Seek(Edge& e, int y);
+
+    std::vector<Edge> edges;      // 有序边表：按 yTop 升序
+    std::vector<Edge*> active;    // 活动边表：按当前 x 升序
+    int minY = 0;
+    int maxY = 0;
+};
+
+template <typename SpanFunc>
+void ActiveEdgeTable::Scan(int yFrom, int yTo, SpanFunc emit) {
+    if (edges.empty()) return;
+    if (yFrom < minY) yFrom = minY;
+    if (yTo > maxY) yTo = maxY;
+    if (yFrom > yTo) return;
+
+    active.clear();
+    size_t next = 0;
+
+    // 起始行之前就已经开始的边直接定位到起始行
+    while (next < edges.size() && edges[next].yTop < yFrom) {
+        Edge& e = edges[next++];
+        if (e.yBottom > yFrom) {
+            Seek(e, yFrom);
+            active.push_back(&e);
+        }
+    }
+
+    for (int y = yFrom; y <= yTo; y++) {
+        // 活动边表为空时直接跳到下一条边开始的扫描线
+        if (active.empty()) {
+            if (next >= edges.size()) break;
+            if (edges[next].yTop > y) {
+                y = edges[next].yTop;
+                if (y > yTo) break;
+            }
+        }
+
+        // 移除已经结束的边
+        size_t kept = 0;
+        for (size_t i = 0; i < active.size(); i++) {
+            if (active[i]->yBottom > y) active[kept++] = active[i];
+        }
+        active.resize(kept);
+
+        // 加入从本行开始的边
+        while (next < edges.size() && edges[next].yTop == y) {
+            Edge& e = edges[next++];
+            e.x = e.xTop;
+            e.err = 0;
+            active.push_back(&e);
+        }
+
+        // 按 x 排序（相邻扫描线之间顺序几乎不变，插入排序接近线性）
+        for (size_t i = 1; i < active.size(); i++) {
+            Edge* e = active[i];
+            size_t j = i;
+            while (j > 0 && active[j - 1]->x > e->x) {
+                active[j] = active[j - 1];
+                j--;
+            }
+            active[j] = e;
+        }
+
+        // 填充交点之间的像素
+        for (size_t i = 0; i + 1 < active.size(); i += 2) {
+            emit(active[i]->x, active[i + 1]->x, y);
+        }
+
+        // 增量更新到下一行
+        for (Edge* e : active) {
+            e->x += e->step;
+            e->err += e->errStep;
+            if (e->err >= e->dy) {
+                e->err -= e->dy;
+                e->x += e->dir;
+            }
+        }
+    }
+}
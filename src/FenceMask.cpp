@@ -0,0 +1,34 @@
+#include "FenceMask.h"
+#include <algorithm>
+
+void FenceMask::Reset(int l, int t, int w, int h) {
+    left = l;
+    top = t;
+    width = w > 0 ? w : 0;
+    height = h > 0 ? h : 0;
+    wordsPerRow = (width + 63) >> 6;
+    bits.assign((size_t)wordsPerRow * height, 0);
+}
+
+void FenceMask::XorSpan(int y, int x1, int x2) {
+    if ((unsigned)(y - top) >= (unsigned)height) return;
+    int a = std::max(x1 - left, 0);
+    int b = std::min(x2 - left, width);
+    if (a >= b) return;
+
+    uint64_t* row = bits.data() + (size_t)(y - top) * wordsPerRow;
+    int wa = a >> 6;
+    int wb = (b - 1) >> 6;
+    uint64_t headMask = ~0ull << (a & 63);
+    uint64_t tailMask = ~0ull >> (63 - ((b - 1) & 63));
+
+    if (wa == wb) {
+        row[wa] ^= headMask & tailMask;
+        return;
+    }
+    row[wa] ^= headMask;
+    for (int i = wa + 1; i < wb; i++) {
+        row[i] = ~row[i];
+    }
+    row[wb] ^= tailMask;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 栅栏填充使用的 1 位/像素掩码
+// 每一行按 64 位字打包，求补（异或）操作按整字进行；
+// 所有边处理完后，ForEachSpan 一次扫描把置位的连续像素输出为水平区间。
+class FenceMask {
+public:
+    // 掩码覆盖的区域：[left, left + width) × [top, top + height)
+    void Reset(int left, int top, int width, int height);
+
+    int Left() const { return left; }
+    int Top() const { return top; }
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // 对第 y 行 [x1, x2) 的像素求补（画布坐标，自动裁剪到掩码范围）
+    void XorSpan(int y, int x1, int x2);
+
+    // 对每个置位像素组成的水平区间调用 emit(x1, x2, y)（两端都包含）
+    template <typename SpanFunc>
+    void ForEachSpan(SpanFunc emit) const;
+
+private:
+    // 从第 bit 位开始查找下一个置位（set=true）或清零（set=false）的位
+    int FindNext(const uint64_t* row, int bit, bool set) const;
+
+    static int CountTrailingZeros(uint64_t v) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, v);
+        return (int)index;
+#else
+        return __builtin_ctzll(v);
+#endif
+    }
+
+    std::vector<uint64_t> bits;
+    int left = 0;
+    int top = 0;
+    int width = 0;
+    int height = 0;
+    int wordsPerRow = 0;
+};
+
+inline int FenceMask::FindNext(const uint64_t* row, int bit, bool set) const {
+    int word = bit >> 6;
+    uint64_t flip = set ? 0 : ~0ull;
+    uint64_t w = (row[word] ^ flip) & (~0ull << (bit & 63));
+    while (w == 0) {
+        if (++word >= wordsPerRow) return width;
+        w = row[word] ^ flip;
+    }
+    int found = (word << 6) + CountTrailingZeros(w);
+    return found < width ? found : width;
+}
+
+template <typename SpanFunc>
+void FenceMask::ForEachSpan(SpanFunc emit) const {
+    for (int row = 0; row < height; row++) {
+        const uint64_t* r = bits.data() + (size_t)row * wordsPerRow;
+        int x = 0;
+        while (x < width) {
+            x = FindNext(r, x, true);
+            if (x >= width) break;
+            int end = FindNext(r, x, false);
+            emit(left + x, left + end - 1, top + row);
+            x = end;
+        }
+    }
+}
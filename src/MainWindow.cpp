@@ -1,6 +1,7 @@
 #include <windows.h>
 #include <windowsx.h>
 #include <commctrl.h>
+#include <cwchar>
 #include "MainWindow.h"
 #include "Canvas.h"
 
@@ -11,6 +12,20 @@ HINSTANCE g_hInst;
 HWND g_hMainWnd;
 Canvas g_canvas;
 
+static const wchar_t* APP_TITLE = L"2023112605乔鹏博";
+
+// 在标题栏显示最近一帧的重绘统计（只在数值变化时更新标题）
+static void ShowFrameStats(HWND hwnd) {
+    static Canvas::FrameStats shown;
+    const Canvas::FrameStats& stats = g_canvas.GetFrameStats();
+    if (stats.presentedPixels == shown.presentedPixels && stats.rebuiltPixels == shown.rebuiltPixels) return;
+    shown = stats;
+    
+    wchar_t title[128];
+    swprintf(title, 128, L"%ls - 重绘 %lld 像素（重建 %lld）", APP_TITLE, stats.presentedPixels, stats.rebuiltPixels);
+    SetWindowTextW(hwnd, title);
+}
+
 // 创建菜单
 HMENU CreateMainMenu() {
     HMENU hMenu = CreateMenu();
@@ -25,6 +40,7 @@ HMENU CreateMainMenu() {
     HMENU hClipMenu = CreatePopupMenu();
     HMENU hLineClipMenu = CreatePopupMenu();
     HMENU hPolyClipMenu = CreatePopupMenu();
+    HMENU hBooleanMenu = CreatePopupMenu();
     
     // 文件菜单
     AppendMenuW(hFileMenu, MF_STRING, ID_FILE_CLEAR, L"清空画布");
@@ -36,6 +52,7 @@ HMENU CreateMainMenu() {
     AppendMenuW(hLineMenu, MF_STRING, ID_LINE_GDI, L"直线 - GDI");
     AppendMenuW(hLineMenu, MF_STRING, ID_LINE_MIDPOINT, L"直线 - 中点法");
     AppendMenuW(hLineMenu, MF_STRING, ID_LINE_BRESENHAM, L"直线 - Bresenham算法");
+    AppendMenuW(hLineMenu, MF_STRING, ID_LINE_RUNSLICE, L"直线 - 游程切片算法");
     AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hLineMenu, L"直线");
     
     // 圆菜单
@@ -48,6 +65,8 @@ HMENU CreateMainMenu() {
     AppendMenuW(hShapeMenu, MF_STRING, ID_RECTANGLE, L"矩形");
     AppendMenuW(hShapeMenu, MF_STRING, ID_POLYLINE, L"多段线");
     AppendMenuW(hShapeMenu, MF_STRING, ID_BSPLINE, L"B样条曲线");
+    AppendMenuW(hShapeMenu, MF_STRING, ID_BSPLINE_QUADRATIC, L"二次B样条曲线");
+    AppendMenuW(hShapeMenu, MF_STRING, ID_BSPLINE_CLAMPED, L"端点插值B样条曲线(NURBS)");
     AppendMenuW(hShapeMenu, MF_SEPARATOR, 0, NULL);
     AppendMenuW(hShapeMenu, MF_STRING, ID_POLYGON, L"任意多边形");
     AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hShapeMenu, L"图形");
@@ -80,15 +99,35 @@ HMENU CreateMainMenu() {
     
     AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hClipMenu, L"裁剪");
     
+    // 布尔运算菜单
+    AppendMenuW(hBooleanMenu, MF_STRING, ID_BOOL_INTERSECTION, L"交集");
+    AppendMenuW(hBooleanMenu, MF_STRING, ID_BOOL_UNION, L"并集");
+    AppendMenuW(hBooleanMenu, MF_STRING, ID_BOOL_DIFFERENCE, L"差集（第一个减第二个）");
+    AppendMenuW(hBooleanMenu, MF_STRING, ID_BOOL_XOR, L"异或");
+    AppendMenuW(hMenu, MF_POPUP, (UINT_PTR)hBooleanMenu, L"布尔运算");
+    
     return hMenu;
 }
 
+// 只让画布报告的变化区域失效，而不是整个窗口
+void InvalidateCanvasDamage(HWND hwnd) {
+    std::vector<Rect> rects;
+    if (!g_canvas.TakeDamage(rects)) {
+        InvalidateRect(hwnd, NULL, FALSE);
+        return;
+    }
+    for (const auto& r : rects) {
+        RECT rc = { r.left, r.top, r.right + 1, r.bottom + 1 };
+        InvalidateRect(hwnd, &rc, FALSE);
+    }
+}
+
 // 处理命令
 void HandleCommand(WPARAM wParam) {
     switch (LOWORD(wParam)) {
     case ID_FILE_CLEAR:
         g_canvas.Clear();
-        InvalidateRect(g_hMainWnd, NULL, FALSE);
+        InvalidateCanvasDamage(g_hMainWnd);
         break;
         
     case ID_FILE_EXIT:
@@ -107,6 +146,10 @@ void HandleCommand(WPARAM wParam) {
         g_canvas.SetDrawMode(DrawMode::LineBresenham);
         break;
         
+    case ID_LINE_RUNSLICE:
+        g_canvas.SetDrawMode(DrawMode::LineRunSlice);
+        break;
+        
     case ID_CIRCLE_GDI:
         g_canvas.SetDrawMode(DrawMode::Circle);
         break;
@@ -131,6 +174,14 @@ void HandleCommand(WPARAM wParam) {
         g_canvas.SetDrawMode(DrawMode::BSpline);
         break;
         
+    case ID_BSPLINE_QUADRATIC:
+        g_canvas.SetDrawMode(DrawMode::BSplineQuadratic);
+        break;
+        
+    case ID_BSPLINE_CLAMPED:
+        g_canvas.SetDrawMode(DrawMode::BSplineClamped);
+        break;
+        
     case ID_FILL_SCANLINE:
         g_canvas.StartSelectModeForFill(FillAlgorithm::ScanLine);
         MessageBox(g_hMainWnd, L"请点击要填充的封闭图形", L"选择填充", MB_OK | MB_ICONINFORMATION);
@@ -176,7 +227,7 @@ void HandleCommand(WPARAM wParam) {
     // 清除裁剪窗口
     case ID_CLEAR_CLIP:
         g_canvas.ClearClipRect();
-        InvalidateRect(g_hMainWnd, NULL, FALSE);
+        InvalidateCanvasDamage(g_hMainWnd);
         MessageBox(g_hMainWnd, L"裁剪窗口已清除", L"清除裁剪窗口", MB_OK | MB_ICONINFORMATION);
         break;
     
@@ -184,7 +235,7 @@ void HandleCommand(WPARAM wParam) {
     case ID_CLIP_LINE_COHEN:
         if (g_canvas.HasClipRect()) {
             g_canvas.ClipLines(LineClipAlgorithm::CohenSutherland);
-            InvalidateRect(g_hMainWnd, NULL, FALSE);
+            InvalidateCanvasDamage(g_hMainWnd);
             MessageBox(g_hMainWnd, L"已使用Cohen-Sutherland算法裁剪所有直线", L"直线裁剪", MB_OK | MB_ICONINFORMATION);
         } else {
             MessageBox(g_hMainWnd, L"请先设置裁剪窗口！", L"错误", MB_OK | MB_ICONWARNING);
@@ -195,7 +246,7 @@ void HandleCommand(WPARAM wParam) {
     case ID_CLIP_LINE_MIDPT:
         if (g_canvas.HasClipRect()) {
             g_canvas.ClipLines(LineClipAlgorithm::MidpointSubdivision);
-            InvalidateRect(g_hMainWnd, NULL, FALSE);
+            InvalidateCanvasDamage(g_hMainWnd);
             MessageBox(g_hMainWnd, L"已使用中点分割算法裁剪所有直线", L"直线裁剪", MB_OK | MB_ICONINFORMATION);
         } else {
             MessageBox(g_hMainWnd, L"请先设置裁剪窗口！", L"错误", MB_OK | MB_ICONWARNING);
@@ -206,7 +257,7 @@ void HandleCommand(WPARAM wParam) {
     case ID_CLIP_POLY_SH:
         if (g_canvas.HasClipRect()) {
             g_canvas.ClipPolygons(PolygonClipAlgorithm::SutherlandHodgman);
-            InvalidateRect(g_hMainWnd, NULL, FALSE);
+            InvalidateCanvasDamage(g_hMainWnd);
             MessageBox(g_hMainWnd, L"已使用Sutherland-Hodgman算法裁剪所有多边形", L"多边形裁剪", MB_OK | MB_ICONINFORMATION);
         } else {
             MessageBox(g_hMainWnd, L"请先设置裁剪窗口！", L"错误", MB_OK | MB_ICONWARNING);
@@ -217,12 +268,33 @@ void HandleCommand(WPARAM wParam) {
     case ID_CLIP_POLY_WA:
         if (g_canvas.HasClipRect()) {
             g_canvas.ClipPolygons(PolygonClipAlgorithm::WeilerAtherton);
-            InvalidateRect(g_hMainWnd, NULL, FALSE);
+            InvalidateCanvasDamage(g_hMainWnd);
             MessageBox(g_hMainWnd, L"已使用Weiler-Atherton算法裁剪所有多边形", L"多边形裁剪", MB_OK | MB_ICONINFORMATION);
         } else {
             MessageBox(g_hMainWnd, L"请先设置裁剪窗口！", L"错误", MB_OK | MB_ICONWARNING);
         }
         break;
+    
+    // 多边形布尔运算
+    case ID_BOOL_INTERSECTION:
+        g_canvas.StartBooleanMode(BooleanOp::Intersection);
+        MessageBox(g_hMainWnd, L"依次点击两个封闭图形，用它们的交集替换两者", L"交集", MB_OK | MB_ICONINFORMATION);
+        break;
+    
+    case ID_BOOL_UNION:
+        g_canvas.StartBooleanMode(BooleanOp::Union);
+        MessageBox(g_hMainWnd, L"依次点击两个封闭图形，用它们的并集替换两者", L"并集", MB_OK | MB_ICONINFORMATION);
+        break;
+    
+    case ID_BOOL_DIFFERENCE:
+        g_canvas.StartBooleanMode(BooleanOp::Difference);
+        MessageBox(g_hMainWnd, L"依次点击两个封闭图形，用第一个减去第二个的结果替换两者", L"差集", MB_OK | MB_ICONINFORMATION);
+        break;
+    
+    case ID_BOOL_XOR:
+        g_canvas.StartBooleanMode(BooleanOp::Xor);
+        MessageBox(g_hMainWnd, L"依次点击两个封闭图形，用它们的异或替换两者", L"异或", MB_OK | MB_ICONINFORMATION);
+        break;
     }
 }
 
@@ -231,13 +303,15 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_COMMAND:
         HandleCommand(wParam);
+        // 切换模式可能取消选中或清除预览
+        InvalidateCanvasDamage(hwnd);
         break;
         
     case WM_LBUTTONDOWN: {
         int x = GET_X_LPARAM(lParam);
         int y = GET_Y_LPARAM(lParam);
         g_canvas.OnMouseLeftDown(x, y);
-        InvalidateRect(hwnd, NULL, FALSE);
+        InvalidateCanvasDamage(hwnd);
         break;
     }
     
@@ -245,7 +319,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         int x = GET_X_LPARAM(lParam);
         int y = GET_Y_LPARAM(lParam);
         g_canvas.OnMouseRightDown(x, y);
-        InvalidateRect(hwnd, NULL, FALSE);
+        InvalidateCanvasDamage(hwnd);
         break;
     }
     
@@ -253,7 +327,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         int x = GET_X_LPARAM(lParam);
         int y = GET_Y_LPARAM(lParam);
         g_canvas.OnMouseMove(x, y);
-        InvalidateRect(hwnd, NULL, FALSE);
+        InvalidateCanvasDamage(hwnd);
         break;
     }
 
@@ -266,22 +340,36 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         HDC hdc = BeginPaint(hwnd, &ps);
         
         // 创建内存DC进行双缓冲
+        // 后备缓冲使用 32bpp 自顶向下的 DIB 段，软件光栅化算法可以直接写其内存；
+        // 只覆盖需要重绘的区域 ps.rcPaint，通过视口原点偏移让绘制代码仍使用窗口坐标，
+        // 最后把该区域 BitBlt 到屏幕
         RECT rect;
         GetClientRect(hwnd, &rect);
+        RECT paint = ps.rcPaint;
+        int paintWidth = paint.right - paint.left;
+        int paintHeight = paint.bottom - paint.top;
+        if (paintWidth <= 0 || paintHeight <= 0) {
+            EndPaint(hwnd, &ps);
+            break;
+        }
         HDC hdcMem = CreateCompatibleDC(hdc);
-        HBITMAP hbmMem = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
+        BITMAPINFO bmi = {};
+        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth = paintWidth;
+        bmi.bmiHeader.biHeight = -paintHeight;
+        bmi.bmiHeader.biPlanes = 1;
+        bmi.bmiHeader.biBitCount = 32;
+        bmi.bmiHeader.biCompression = BI_RGB;
+        void* bits = NULL;
+        HBITMAP hbmMem = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
         HBITMAP hbmOld = (HBITMAP)SelectObject(hdcMem, hbmMem);
+        SetViewportOrgEx(hdcMem, -paint.left, -paint.top, NULL);
         
-        // 填充背景
-        HBRUSH hBrush = CreateSolidBrush(RGB(255, 255, 255));
-        FillRect(hdcMem, &rect, hBrush);
-        DeleteObject(hBrush);
-        
-        // 绘制图形
-        g_canvas.Draw(hdcMem);
+        // 绘制图形（背景与已完成的图形来自画布的缓存位图，覆盖整个重绘区域）
+        g_canvas.Draw(hdcMem, rect.right, rect.bottom);
         
         // 复制到屏幕
-        BitBlt(hdc, 0, 0, rect.right, rect.bottom, hdcMem, 0, 0, SRCCOPY);
+        BitBlt(hdc, paint.left, paint.top, paintWidth, paintHeight, hdcMem, paint.left, paint.top, SRCCOPY);
         
         // 清理
         SelectObject(hdcMem, hbmOld);
@@ -289,6 +377,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         DeleteDC(hdcMem);
         
         EndPaint(hwnd, &ps);
+        ShowFrameStats(hwnd);
         break;
     }
     
@@ -324,7 +413,7 @@ HWND CreateMainWindow() {
     return CreateWindowEx(
         0,
         L"GraphicsDrawingApp",
-        L"2023112605乔鹏博",
+        APP_TITLE,
         WS_OVERLAPPEDWINDOW,
         CW_USEDEFAULT, CW_USEDEFAULT,
         1024, 768,
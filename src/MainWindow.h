@@ -12,6 +12,7 @@ extern HWND g_hMainWnd;
 #define ID_LINE_GDI         2001
 #define ID_LINE_MIDPOINT    2002
 #define ID_LINE_BRESENHAM   2003
+#define ID_LINE_RUNSLICE    2004
 
 #define ID_CIRCLE_GDI       3001
 #define ID_CIRCLE_MIDPOINT  3002
@@ -20,6 +21,8 @@ extern HWND g_hMainWnd;
 #define ID_RECTANGLE        4001
 #define ID_POLYLINE         4002
 #define ID_BSPLINE          4003
+#define ID_BSPLINE_QUADRATIC 4004
+#define ID_BSPLINE_CLAMPED  4005
 
 #define ID_FILL_SCANLINE    5001
 #define ID_FILL_FENCE       5002
@@ -47,6 +50,12 @@ extern HWND g_hMainWnd;
 #define ID_CLIP_POLY_SH     8201   // Sutherland-Hodgman多边形裁剪
 #define ID_CLIP_POLY_WA     8202   // Weiler-Atherton多边形裁剪
 
+// 多边形布尔运算
+#define ID_BOOL_INTERSECTION 9001  // 交集
+#define ID_BOOL_UNION        9002  // 并集
+#define ID_BOOL_DIFFERENCE   9003  // 差集
+#define ID_BOOL_XOR          9004  // 异或
+
 // 函数声明
 HMENU CreateMainMenu();
 void HandleCommand(WPARAM wParam);
@@ -0,0 +1,328 @@
+#include "NurbsCurve.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// 固定次数的 de Boor 各层循环完全展开（GCC 在 -O2 下不会展开这种三角形的嵌套循环）
+#if defined(__GNUC__)
+#define NURBS_UNROLL _Pragma("GCC unroll 8")
+#else
+#define NURBS_UNROLL
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NURBS_CURVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// 就近取整（与 SplineTessellator 相同：lrint 与 SSE2 的 cvtpd 使用相同的舍入模式）
+inline Point RoundPoint(double x, double y) {
+#ifdef NURBS_CURVE_SSE2
+    __m128i r = _mm_cvtpd_epi32(_mm_setr_pd(x, y));
+    return Point(_mm_cvtsi128_si32(r), _mm_cvtsi128_si32(_mm_srli_si128(r, 4)));
+#else
+    return Point((int)lrint(x), (int)lrint(y));
+#endif
+}
+
+}
+
+bool NurbsCurve::Set(int deg, const std::vector<Point>& points,
+                     const std::vector<double>& knotVector, const std::vector<double>& weights) {
+    degree = 0;
+    spanCount = 0;
+    size_t count = points.size();
+    if (deg < 1 || count < (size_t)deg + 1) return false;
+    if (knotVector.size() != count + deg + 1) return false;
+    for (size_t i = 1; i < knotVector.size(); i++) {
+        if (knotVector[i] < knotVector[i - 1]) return false;
+    }
+    if (!weights.empty() && weights.size() != count) return false;
+
+    hx.resize(count);
+    hy.resize(count);
+    hw.resize(count);
+    bool anyWeight = false;
+    for (size_t i = 0; i < count; i++) {
+        double w = weights.empty() ? 1.0 : weights[i];
+        if (!(w > 0.0)) return false;
+        hx[i] = points[i].x * w;
+        hy[i] = points[i].y * w;
+        hw[i] = w;
+        anyWeight = anyWeight || w != 1.0;
+        minWeight = i == 0 ? w : std::min(minWeight, w);
+        maxWeight = i == 0 ? w : std::max(maxWeight, w);
+    }
+    knots = knotVector;
+    degree = deg;
+    spanCount = count - deg;
+    weightRatio = maxWeight / minWeight;
+    rational = anyWeight;
+    return true;
+}
+
+bool NurbsCurve::Append(const Point& point, double weight, double knot) {
+    if (IsEmpty() || !(weight > 0.0) || knot < knots.back()) return false;
+    hx.push_back(point.x * weight);
+    hy.push_back(point.y * weight);
+    hw.push_back(weight);
+    knots.push_back(knot);
+    spanCount++;
+    minWeight = std::min(minWeight, weight);
+    maxWeight = std::max(maxWeight, weight);
+    weightRatio = maxWeight / minWeight;
+    rational = rational || weight != 1.0;
+    return true;
+}
+
+void NurbsCurve::UniformKnots(int degree, size_t count, std::vector<double>& knots) {
+    knots.resize(count + degree + 1);
+    for (size_t i = 0; i < knots.size(); i++) knots[i] = (double)i;
+}
+
+void NurbsCurve::ClampedKnots(int degree, size_t count, std::vector<double>& knots) {
+    knots.resize(count + degree + 1);
+    int interior = (int)count - degree;   // 有效参数范围内的段数
+    for (size_t i = 0; i < knots.size(); i++) {
+        int v = (int)i - degree;
+        knots[i] = (double)std::max(0, std::min(v, interior));
+    }
+}
+
+size_t NurbsCurve::FindSpan(double u) const {
+    // 在 knots[degree .. degree + spanCount] 中二分查找 knots[i] <= u < knots[i + 1]
+    size_t lo = degree, hi = degree + spanCount;
+    if (u >= knots[hi]) {
+        // 参数在末端：取最后一个长度不为 0 的段
+        size_t i = hi - 1;
+        while (i > lo && knots[i] == knots[i + 1]) i--;
+        return i - degree;
+    }
+    if (u <= knots[lo]) {
+        size_t i = lo;
+        while (i + 1 < hi && knots[i] == knots[i + 1]) i++;
+        return i - degree;
+    }
+    while (hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if (u < knots[mid]) hi = mid; else lo = mid;
+    }
+    return lo - degree;
+}
+
+// de Boor：d[j] = P[k + j]（j = 0..degree），逐层
+//   alpha = (u - t[i]) / (t[i + degree + 1 - r] - t[i])，i = k + j
+//   d[j] = (1 - alpha) d[j - 1] + alpha d[j]   （j 从 degree 递减到 r）
+// 最后 d[degree] 即曲线上的齐次点。同一段内各层用到的节点只与 k 有关，
+// 先把 t[i] 和 1 / (t[i + degree + 1 - r] - t[i]) 按 (r, j) 的遍历顺序算好，每个参数只做乘加
+void NurbsCurve::SpanCoefficients(size_t k, double* left, double* scale) const {
+    size_t c = 0;
+    for (int r = 1; r <= degree; r++) {
+        for (int j = degree; j >= r; j--, c++) {
+            size_t i = k + j;
+            double right = knots[i + degree + 1 - r];
+            left[c] = knots[i];
+            scale[c] = right > knots[i] ? 1.0 / (right - knots[i]) : 0.0;
+        }
+    }
+}
+
+void NurbsCurve::DeBoor(size_t k, double u, const double* left, const double* scale,
+                        double* work, double& x, double& y) const {
+    double* dx = work;
+    double* dy = work + degree + 1;
+    double* dw = work + 2 * (degree + 1);
+    for (int j = 0; j <= degree; j++) {
+        dx[j] = hx[k + j];
+        dy[j] = hy[k + j];
+        dw[j] = hw[k + j];
+    }
+    size_t c = 0;
+    for (int r = 1; r <= degree; r++) {
+        for (int j = degree; j >= r; j--, c++) {
+            double alpha = (u - left[c]) * scale[c];
+            dx[j] = dx[j - 1] + alpha * (dx[j] - dx[j - 1]);
+            dy[j] = dy[j - 1] + alpha * (dy[j] - dy[j - 1]);
+            dw[j] = dw[j - 1] + alpha * (dw[j] - dw[j - 1]);
+        }
+    }
+    x = dx[degree] / dw[degree];
+    y = dy[degree] / dw[degree];
+}
+
+// 固定次数的段内求值。段内曲线的齐次坐标 (x·w, y·w, w) 都是 u 的 D 次多项式：
+// 参数较多时先用 de Boor 求出段内 D + 1 个等距节点上的值，换成牛顿插值形式（差商），
+// 每个参数只需 D 次乘加；参数少时逐个用 de Boor 求值。两种情况的循环都在编译期展开，
+// 权重全为 1 时省去权重分量和最后的除法
+template <int D, bool Rational>
+void NurbsCurve::EvaluateSpanFixed(size_t k, const double* params, size_t n, Point* dst) const {
+    const int C = D * (D + 1) / 2;
+    double left[C], scale[C];
+    SpanCoefficients(k, left, scale);
+    double px[D + 1], py[D + 1], pw[D + 1];
+    for (int j = 0; j <= D; j++) {
+        px[j] = hx[k + j];
+        py[j] = hy[k + j];
+        pw[j] = hw[k + j];
+    }
+    auto deBoor = [&](double u, double& x, double& y, double& w) {
+        double dx[D + 1], dy[D + 1], dw[D + 1];
+        NURBS_UNROLL
+        for (int j = 0; j <= D; j++) {
+            dx[j] = px[j];
+            dy[j] = py[j];
+            dw[j] = pw[j];
+        }
+        int c = 0;
+        NURBS_UNROLL
+        for (int r = 1; r <= D; r++) {
+            NURBS_UNROLL
+            for (int j = D; j >= r; j--, c++) {
+                double alpha = (u - left[c]) * scale[c];
+                dx[j] = dx[j - 1] + alpha * (dx[j] - dx[j - 1]);
+                dy[j] = dy[j - 1] + alpha * (dy[j] - dy[j - 1]);
+                if (Rational) dw[j] = dw[j - 1] + alpha * (dw[j] - dw[j - 1]);
+            }
+        }
+        x = dx[D];
+        y = dy[D];
+        w = Rational ? dw[D] : 1.0;
+    };
+    auto store = [&](size_t i, double x, double y, double w) {
+        if (Rational) {
+            x /= w;
+            y /= w;
+        }
+        dst[i] = RoundPoint(x, y);
+    };
+
+    double u0 = SpanStart(k), u1 = SpanEnd(k);
+    if (n <= 2 * (D + 1) || !(u1 > u0)) {
+        for (size_t i = 0; i < n; i++) {
+            double x, y, w;
+            deBoor(params[i], x, y, w);
+            store(i, x, y, w);
+        }
+        return;
+    }
+
+    // 节点 t[m] = u0 + m h 上的值，原地换成差商 c[m] = f[t0..tm]
+    double t[D + 1], cx[D + 1], cy[D + 1], cw[D + 1];
+    double h = (u1 - u0) / D;
+    for (int m = 0; m <= D; m++) {
+        t[m] = m == D ? u1 : u0 + m * h;
+        deBoor(t[m], cx[m], cy[m], cw[m]);
+    }
+    for (int r = 1; r <= D; r++) {
+        for (int m = D; m >= r; m--) {
+            double inv = 1.0 / (t[m] - t[m - r]);
+            cx[m] = (cx[m] - cx[m - 1]) * inv;
+            cy[m] = (cy[m] - cy[m - 1]) * inv;
+            if (Rational) cw[m] = (cw[m] - cw[m - 1]) * inv;
+        }
+    }
+    // p(u) = c0 + (u - t0)(c1 + (u - t1)(c2 + ...))
+    for (size_t i = 0; i < n; i++) {
+        double u = params[i];
+        double x = cx[D], y = cy[D], w = Rational ? cw[D] : 1.0;
+        NURBS_UNROLL
+        for (int m = D - 1; m >= 0; m--) {
+            double d = u - t[m];
+            x = cx[m] + d * x;
+            y = cy[m] + d * y;
+            if (Rational) w = cw[m] + d * w;
+        }
+        store(i, x, y, w);
+    }
+}
+
+Point NurbsCurve::Evaluate(double u) const {
+    if (IsEmpty()) return Point();
+    Point p;
+    EvaluateSpan(FindSpan(u), &u, 1, &p);
+    return p;
+}
+
+void NurbsCurve::Evaluate(const double* params, size_t n, std::vector<Point>& out) const {
+    if (IsEmpty() || n == 0) return;
+    size_t k = FindSpan(params[0]);
+    size_t i = 0;
+    while (i < n) {
+        double u = params[i];
+        // 参数递增时顺序推进到所在的段，否则退回二分查找
+        if (u < SpanStart(k)) {
+            k = FindSpan(u);
+        } else {
+            while (k + 1 < spanCount && u >= SpanEnd(k)) k++;
+        }
+        // 落在同一段内的连续参数一起求值（末段包括其后超出范围的参数）
+        size_t end = i + 1;
+        double spanStart = std::min(u, SpanStart(k));
+        double spanEnd = k + 1 == spanCount ? std::numeric_limits<double>::infinity() : SpanEnd(k);
+        while (end < n && params[end] >= spanStart && params[end] < spanEnd) end++;
+        EvaluateSpan(k, params + i, end - i, out);
+        i = end;
+    }
+}
+
+void NurbsCurve::EvaluateSpan(size_t k, const double* params, size_t n, std::vector<Point>& out) const {
+    size_t base = out.size();
+    out.resize(base + n);
+    EvaluateSpan(k, params, n, out.data() + base);
+}
+
+void NurbsCurve::EvaluateSpan(size_t k, const double* params, size_t n, Point* dst) const {
+    switch (degree) {
+    case 1: return rational ? EvaluateSpanFixed<1, true>(k, params, n, dst) : EvaluateSpanFixed<1, false>(k, params, n, dst);
+    case 2: return rational ? EvaluateSpanFixed<2, true>(k, params, n, dst) : EvaluateSpanFixed<2, false>(k, params, n, dst);
+    case 3: return rational ? EvaluateSpanFixed<3, true>(k, params, n, dst) : EvaluateSpanFixed<3, false>(k, params, n, dst);
+    case 4: return rational ? EvaluateSpanFixed<4, true>(k, params, n, dst) : EvaluateSpanFixed<4, false>(k, params, n, dst);
+    case 5: return rational ? EvaluateSpanFixed<5, true>(k, params, n, dst) : EvaluateSpanFixed<5, false>(k, params, n, dst);
+    default: break;
+    }
+
+    // 更高次数：各层系数与工作区按次数分配，每段一次
+    size_t coefCount = (size_t)degree * (degree + 1) / 2;
+    std::vector<double> buffer(2 * coefCount + 3 * ((size_t)degree + 1));
+    double* left = buffer.data();
+    double* scale = left + coefCount;
+    double* work = scale + coefCount;
+    SpanCoefficients(k, left, scale);
+    for (size_t i = 0; i < n; i++) {
+        double x, y;
+        DeBoor(k, params[i], left, scale, work, x, y);
+        dst[i] = RoundPoint(x, y);
+    }
+}
+
+// Wang 公式：n 次 Bézier 曲线等分为 m 段时折线偏差不超过 n(n-1) / (8 m²) · max|P[i] - 2P[i+1] + P[i+2]|
+// B 样条段的控制点不是 Bézier 控制点，这里作为估计使用（对均匀三次 B 样条偏保守）
+int NurbsCurve::StepsForTolerance(size_t k, double tolerance) const {
+    if (SpanEnd(k) <= SpanStart(k)) return 0;
+    double maxSecond = 0.0;
+    for (int j = 0; j + 2 <= degree; j++) {
+        double x0 = hx[k + j] / hw[k + j],         y0 = hy[k + j] / hw[k + j];
+        double x1 = hx[k + j + 1] / hw[k + j + 1], y1 = hy[k + j + 1] / hw[k + j + 1];
+        double x2 = hx[k + j + 2] / hw[k + j + 2], y2 = hy[k + j + 2] / hw[k + j + 2];
+        double ex = x0 - 2.0 * x1 + x2, ey = y0 - 2.0 * y1 + y2;
+        maxSecond = std::max(maxSecond, sqrt(ex * ex + ey * ey));
+    }
+    if (tolerance <= 0.0) return MAX_STEPS;
+    double bound = degree * (degree - 1) / 8.0 * maxSecond * weightRatio;
+    double steps = ceil(sqrt(bound / tolerance));
+    return (int)std::min<double>(std::max(steps, 1.0), MAX_STEPS);
+}
+
+void NurbsCurve::TessellateSpan(size_t k, double tolerance, std::vector<Point>& out) const {
+    int steps = StepsForTolerance(k, tolerance);
+    if (steps == 0) return;
+    double u0 = SpanStart(k), u1 = SpanEnd(k);
+    std::vector<double> params(steps + 1);
+    for (int j = 0; j <= steps; j++) {
+        params[j] = u0 + (u1 - u0) * j / steps;
+    }
+    params[steps] = u1;
+    EvaluateSpan(k, params.data(), params.size(), out);
+}
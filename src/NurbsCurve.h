@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "Point.h"
+
+// 任意次数的 NURBS 曲线（非均匀有理 B 样条），用 de Boor 算法求值
+// degree 次曲线有 count 个控制点、count + degree + 1 个非递减节点；
+// 曲线的有效参数范围是 [knots[degree], knots[count]]，分成 count - degree 段，
+// 第 k 段对应节点区间 [knots[degree + k], knots[degree + k + 1]]，只受控制点 k..k+degree 影响。
+// 权重全为 1 时就是普通的 B 样条；均匀节点的三次曲线与 SplineTessellator 的三次均匀 B 样条相同。
+class NurbsCurve {
+public:
+    // 设置曲线；weights 为空表示全部为 1。参数不合法（次数 < 1、控制点不足、
+    // 节点个数不对或递减、权重个数不对或不为正）时返回 false，曲线保持为空
+    bool Set(int degree, const std::vector<Point>& points,
+             const std::vector<double>& knots, const std::vector<double>& weights);
+
+    // 在末尾追加一个控制点和一个节点，曲线随之多出一段，已有的段不变；
+    // 曲线为空、权重不为正或节点小于最后一个节点时返回 false，曲线不变
+    bool Append(const Point& point, double weight, double knot);
+    void Clear() { degree = 0; spanCount = 0; }
+
+    // 常用节点向量
+    // 均匀节点 0, 1, ..., count + degree：曲线不经过端点控制点，增加控制点时已有的段不变
+    static void UniformKnots(int degree, size_t count, std::vector<double>& knots);
+    // 两端各重复 degree + 1 次的均匀节点：曲线从第一个控制点开始、到最后一个控制点结束
+    static void ClampedKnots(int degree, size_t count, std::vector<double>& knots);
+
+    bool IsEmpty() const { return spanCount == 0; }
+    int Degree() const { return degree; }
+    size_t SpanCount() const { return spanCount; }
+    size_t PointCount() const { return spanCount == 0 ? 0 : spanCount + degree; }
+    double LastKnot() const { return knots.back(); }
+    double SpanStart(size_t k) const { return knots[degree + k]; }
+    double SpanEnd(size_t k) const { return knots[degree + k + 1]; }
+
+    // 参数 u 所在的段（u 超出范围时取首段或末段；长度为 0 的段会被跳过）
+    size_t FindSpan(double u) const;
+
+    // 单点求值（就近取整）
+    Point Evaluate(double u) const;
+    // 批量求值：params 非递减时段的查找只向前推进，不重复二分查找
+    void Evaluate(const double* params, size_t n, std::vector<Point>& out) const;
+    // 第 k 段上的批量求值（params 都在该段的节点区间内）
+    void EvaluateSpan(size_t k, const double* params, size_t n, std::vector<Point>& out) const;
+
+    // 按平直度容差（像素）估计第 k 段需要的等分数：把 Wang 公式用在该段的控制点上，
+    // 有理曲线再按权重的最大最小比放大；长度为 0 的段返回 0
+    int StepsForTolerance(size_t k, double tolerance) const;
+    // 按容差等分细分第 k 段，追加 steps + 1 个点（包括两端）
+    void TessellateSpan(size_t k, double tolerance, std::vector<Point>& out) const;
+
+    // 自适应细分的等分数上限
+    static const int MAX_STEPS = 1024;
+
+private:
+    // 第 k 段 de Boor 各层的节点左端和节点区间长度的倒数（各 degree (degree + 1) / 2 个）
+    void SpanCoefficients(size_t k, double* left, double* scale) const;
+    // 第 k 段上的批量求值，结果写到 dst[0..n)
+    void EvaluateSpan(size_t k, const double* params, size_t n, Point* dst) const;
+    // 齐次坐标下的 de Boor 算法；work 至少容纳 3 * (degree + 1) 个 double
+    void DeBoor(size_t k, double u, const double* left, const double* scale,
+                double* work, double& x, double& y) const;
+    // 次数为 D 时的 EvaluateSpan
+    template <int D, bool Rational>
+    void EvaluateSpanFixed(size_t k, const double* params, size_t n, Point* dst) const;
+
+    int degree = 0;
+    size_t spanCount = 0;
+    std::vector<double> hx, hy, hw;   // 齐次控制点 (x·w, y·w, w)
+    std::vector<double> knots;
+    double minWeight = 1.0, maxWeight = 1.0;
+    double weightRatio = 1.0;         // 最大权重 / 最小权重
+    bool rational = false;            // 是否有不为 1 的权重
+};
@@ -71,4 +71,24 @@ public:
     bool Contains(const Point& p) const {
         return p.x >= left && p.x <= right && p.y >= top && p.y <= bottom;
     }
+    
+    // 以下按包含边界的像素范围理解矩形
+    bool Intersects(const Rect& r) const {
+        return left <= r.right && r.left <= right && top <= r.bottom && r.top <= bottom;
+    }
+    
+    bool Contains(const Rect& r) const {
+        return r.left >= left && r.right <= right && r.top >= top && r.bottom <= bottom;
+    }
+    
+    // 向四周扩展 d 个像素
+    Rect Inflate(int d) const {
+        return Rect(left - d, top - d, right + d, bottom + d);
+    }
+    
+    // 同时包含两个矩形的最小矩形
+    Rect Union(const Rect& r) const {
+        return Rect(left < r.left ? left : r.left, top < r.top ? top : r.top,
+                    right > r.right ? right : r.right, bottom > r.bottom ? bottom : r.bottom);
+    }
 };
@@ -0,0 +1,387 @@
+#include "PolygonBoolean.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+#include <numeric>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// 整数坐标的精确方向判断：> 0 表示 c 在 a→b 的左侧（y 轴向上时），= 0 表示三点共线
+int64_t OrientInt(const Point& a, const Point& b, const Point& c) {
+    return (int64_t)(b.x - a.x) * (c.y - a.y) - (int64_t)(b.y - a.y) * (c.x - a.x);
+}
+
+bool LessInt(const Point& a, const Point& b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+// 已知 q 与边 a→b 共线时，q 是否严格位于边的内部
+bool StrictlyInside(const Point& a, const Point& b, const Point& q) {
+    return LessInt(a, q) && LessInt(q, b);
+}
+
+// 区域在运算结果中：parity 的第 0、1 位为在 subject、clip 内
+bool InResult(BooleanOp op, unsigned parity) {
+    bool inA = (parity & 1) != 0, inB = (parity & 2) != 0;
+    switch (op) {
+    case BooleanOp::Intersection: return inA && inB;
+    case BooleanOp::Union:        return inA || inB;
+    case BooleanOp::Difference:   return inA && !inB;
+    default:                      return inA != inB;
+    }
+}
+
+// 环的有向面积（按 y 轴向上计算，外环为正、洞为负）
+double SignedArea(const std::vector<Point>& ring) {
+    double sum = 0;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        sum += (double)ring[j].x * ring[i].y - (double)ring[i].x * ring[j].y;
+    }
+    return sum / 2;
+}
+
+// 点 (x, y) 是否在环内（奇偶规则）
+bool RingContains(const std::vector<Point>& ring, double x, double y) {
+    bool inside = false;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        const Point& a = ring[i];
+        const Point& b = ring[j];
+        if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (double)(b.y - a.y)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+}
+
+double PolygonBoolean::Orient(const PointD& a, const PointD& b, const PointD& c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+void PolygonBoolean::Compute(const Rings& subject, const Rings& clip, BooleanOp op, Rings& result) {
+    result.clear();
+    edges.clear();
+    splits.clear();
+    pieces.clear();
+    events.clear();
+    status.clear();
+    links.clear();
+
+    AddRings(subject, 1);
+    AddRings(clip, 2);
+    if (edges.empty()) return;
+
+    FindSplits();
+    BuildPieces();
+    Classify(op);
+    Connect(result);
+}
+
+void PolygonBoolean::AddRings(const Rings& rings, uint8_t owner) {
+    for (const auto& r : rings) {
+        if (r.size() < 3) continue;
+        for (size_t i = 0; i < r.size(); i++) {
+            const Point& p = r[i];
+            const Point& q = r[i + 1 == r.size() ? 0 : i + 1];
+            if (p == q) continue;
+            edges.push_back(LessInt(p, q) ? Edge{ p, q, owner } : Edge{ q, p, owner });
+        }
+    }
+}
+
+// 按 x 扫描：边按左端点 x 依次加入，只与 x 范围重叠（右端点不在扫描线左边）且 y 范围重叠的活动边检查。
+// 活动边放入它的 y 范围覆盖的每个等高横条（槽高取边的平均高度），加入时只查看自己覆盖的槽；
+// 一对边同在多个槽中时只在两者 y 重叠部分下端所在的槽里检查。
+// 同一多边形内的边也要检查，自交点同样需要切开
+void PolygonBoolean::FindSplits() {
+    order.resize(edges.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j) { return edges[i].a.x < edges[j].a.x; });
+
+    // 槽的划分：[ylo, ylo + height) 为第 0 槽，槽数不超过边数的 4 倍
+    int64_t ylo = std::min(edges[0].a.y, edges[0].b.y), yhi = ylo, heightSum = 0;
+    for (const Edge& e : edges) {
+        ylo = std::min<int64_t>(ylo, std::min(e.a.y, e.b.y));
+        yhi = std::max<int64_t>(yhi, std::max(e.a.y, e.b.y));
+        heightSum += std::abs((int64_t)e.b.y - e.a.y);
+    }
+    int64_t total = (int64_t)edges.size();
+    int64_t height = std::max<int64_t>(1, (heightSum + total - 1) / total);
+    int64_t count = (yhi - ylo) / height + 1;
+    if (count > 4 * total) {
+        count = 4 * total;
+        height = (yhi - ylo) / count + 1;
+    }
+    auto slabOf = [&](int y) { return (uint32_t)(((int64_t)y - ylo) / height); };
+
+    for (uint32_t s = 0; s < slabCount; s++) slabs[s].clear();
+    slabCount = (uint32_t)count;
+    if (slabs.size() < slabCount) slabs.resize(slabCount);
+
+    for (uint32_t i : order) {
+        const Edge& e = edges[i];
+        int ymin = std::min(e.a.y, e.b.y), ymax = std::max(e.a.y, e.b.y);
+        for (uint32_t s = slabOf(ymin), last = slabOf(ymax); s <= last; s++) {
+            std::vector<uint32_t>& active = slabs[s];
+            for (size_t k = 0; k < active.size();) {
+                uint32_t j = active[k];
+                const Edge& t = edges[j];
+                if (t.b.x < e.a.x) {
+                    active[k] = active.back();
+                    active.pop_back();
+                    continue;
+                }
+                k++;
+                int tmin = std::min(t.a.y, t.b.y);
+                if (std::max(t.a.y, t.b.y) < ymin || tmin > ymax) continue;
+                if (slabOf(std::max(ymin, tmin)) != s) continue;
+                TestPair(j, i);
+            }
+            active.push_back(i);
+        }
+    }
+}
+
+// 两条边的所有接触：共线重叠时互相在对方的端点处切开，端点落在另一条边内部时切开另一条边，
+// 真正相交时两条边都在交点处切开（交点由整数方向值求出，两边共用同一个点）
+void PolygonBoolean::TestPair(uint32_t i, uint32_t j) {
+    const Edge& s = edges[i];
+    const Edge& t = edges[j];
+    int64_t d1 = OrientInt(s.a, s.b, t.a);
+    int64_t d2 = OrientInt(s.a, s.b, t.b);
+    if (d1 == 0 && d2 == 0) {
+        if (StrictlyInside(s.a, s.b, t.a)) AddSplit(i, t.a);
+        if (StrictlyInside(s.a, s.b, t.b)) AddSplit(i, t.b);
+        if (StrictlyInside(t.a, t.b, s.a)) AddSplit(j, s.a);
+        if (StrictlyInside(t.a, t.b, s.b)) AddSplit(j, s.b);
+        return;
+    }
+    int64_t d3 = OrientInt(t.a, t.b, s.a);
+    int64_t d4 = OrientInt(t.a, t.b, s.b);
+    if (d1 == 0 && StrictlyInside(s.a, s.b, t.a)) AddSplit(i, t.a);
+    if (d2 == 0 && StrictlyInside(s.a, s.b, t.b)) AddSplit(i, t.b);
+    if (d3 == 0 && StrictlyInside(t.a, t.b, s.a)) AddSplit(j, s.a);
+    if (d4 == 0 && StrictlyInside(t.a, t.b, s.b)) AddSplit(j, s.b);
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) {
+        double u = (double)d3 / ((double)d3 - (double)d4);
+        double v = (double)d1 / ((double)d1 - (double)d2);
+        PointD p = { s.a.x + u * (s.b.x - s.a.x), s.a.y + u * (s.b.y - s.a.y) };
+        AddSplit(i, u, p);
+        AddSplit(j, v, p);
+    }
+}
+
+void PolygonBoolean::AddSplit(uint32_t edge, const Point& q) {
+    const Edge& e = edges[edge];
+    double key = e.b.x != e.a.x ? (double)(q.x - e.a.x) / (e.b.x - e.a.x) : (double)(q.y - e.a.y) / (e.b.y - e.a.y);
+    AddSplit(edge, key, PointD{ (double)q.x, (double)q.y });
+}
+
+void PolygonBoolean::AddSplit(uint32_t edge, double key, const PointD& p) {
+    splits.push_back({ edge, key, p });
+}
+
+void PolygonBoolean::BuildPieces() {
+    std::sort(splits.begin(), splits.end(), [](const Split& a, const Split& b) {
+        return a.edge != b.edge ? a.edge < b.edge : a.key < b.key;
+    });
+
+    auto addPiece = [&](PointD a, PointD b, uint8_t owner) {
+        if (a == b) return;
+        if (Less(b, a)) std::swap(a, b);
+        pieces.push_back({ a, b, owner, 0 });
+    };
+    size_t s = 0;
+    for (uint32_t i = 0; i < (uint32_t)edges.size(); i++) {
+        const Edge& e = edges[i];
+        PointD prev = { (double)e.a.x, (double)e.a.y };
+        for (; s < splits.size() && splits[s].edge == i; s++) {
+            addPiece(prev, splits[s].p, e.owner);
+            prev = splits[s].p;
+        }
+        addPiece(prev, PointD{ (double)e.b.x, (double)e.b.y }, e.owner);
+    }
+
+    // 重合的段合并为一段：两个多边形都经过时两者的奇偶性都翻转，同一多边形经过两次则相互抵消
+    std::sort(pieces.begin(), pieces.end(), [](const Piece& p, const Piece& q) {
+        if (p.a != q.a) return Less(p.a, q.a);
+        return Less(p.b, q.b);
+    });
+    size_t out = 0;
+    for (size_t k = 0; k < pieces.size();) {
+        Piece merged = pieces[k];
+        for (k++; k < pieces.size() && pieces[k].a == merged.a && pieces[k].b == merged.b; k++) {
+            merged.owner ^= pieces[k].owner;
+        }
+        if (merged.owner != 0) pieces[out++] = merged;
+    }
+    pieces.resize(out);
+}
+
+// 扫描线上的段按自下而上排列，且彼此不相交，次序在共同存在期间不变：
+// 新段下方区域的奇偶性 = 紧邻其下的段下方的奇偶性再翻转该段所属的多边形。
+// 竖直段视为斜率无穷大，“下方”即右侧
+void PolygonBoolean::Classify(BooleanOp op) {
+    events.reserve(pieces.size() * 2);
+    for (uint32_t i = 0; i < (uint32_t)pieces.size(); i++) {
+        events.push_back({ pieces[i].a, i, true });
+        events.push_back({ pieces[i].b, i, false });
+    }
+    // 同一点处先移出结束的段，再自下而上加入新段
+    std::sort(events.begin(), events.end(), [&](const Event& e, const Event& f) {
+        if (e.p != f.p) return Less(e.p, f.p);
+        if (e.left != f.left) return !e.left;
+        if (e.left) {
+            double o = Orient(e.p, pieces[e.piece].b, pieces[f.piece].b);
+            if (o != 0) return o > 0;
+        }
+        return e.piece < f.piece;
+    });
+
+    // 每段加入时记下它在有序集合中的位置，移出时直接删除
+    statusPos.resize(pieces.size());
+    for (const Event& e : events) {
+        Piece& s = pieces[e.piece];
+        if (!e.left) {
+            status.erase(statusPos[e.piece]);
+            continue;
+        }
+
+        auto pos = status.insert(e.piece).first;
+        statusPos[e.piece] = pos;
+        if (pos != status.begin()) {
+            const Piece& prev = pieces[*std::prev(pos)];
+            s.below = prev.below ^ prev.owner;
+        } else {
+            s.below = 0;
+        }
+
+        // 两侧结果不同的段是结果的边界，方向取结果区域在左侧（上方）
+        bool belowIn = InResult(op, s.below);
+        bool aboveIn = InResult(op, s.below ^ s.owner);
+        if (belowIn != aboveIn) {
+            links.push_back(aboveIn ? Link{ s.a, s.b, false } : Link{ s.b, s.a, false });
+        }
+    }
+}
+
+bool PolygonBoolean::Below(uint32_t t, const Piece& s) const {
+    const Piece& pt = pieces[t];
+    double o = Orient(pt.a, pt.b, s.a);
+    if (o != 0) return o > 0;
+    return Orient(pt.a, pt.b, s.b) > 0;
+}
+
+// 两段同在扫描线上时互不相交，以左端点靠后的段为准比较即可；左端点相同的段在另一端处分开
+bool PolygonBoolean::StatusLess::operator()(uint32_t i, uint32_t j) const {
+    if (i == j) return false;
+    const std::vector<Piece>& pieces = engine->pieces;
+    if (Less(pieces[i].a, pieces[j].a)) return engine->Below(i, pieces[j]);
+    return !engine->Below(j, pieces[i]);
+}
+
+// 每个顶点的入边与出边数目相等。从任一未用的边出发，在每个顶点选择从来向顺时针转角最小的出边，
+// 使多个环在同一点相接时各自闭合
+void PolygonBoolean::Connect(Rings& result) {
+    order.resize(links.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t i, uint32_t j) { return Less(links[i].from, links[j].from); });
+    auto fromLess = [&](uint32_t i, const PointD& p) { return Less(links[i].from, p); };
+    auto lessFrom = [&](const PointD& p, uint32_t i) { return Less(p, links[i].from); };
+
+    std::vector<Point> out;
+    for (uint32_t start = 0; start < (uint32_t)links.size(); start++) {
+        if (links[start].used) continue;
+        ring.clear();
+        uint32_t current = start;
+        bool closed = false;
+        for (;;) {
+            Link& link = links[current];
+            link.used = true;
+            ring.push_back(link.from);
+            if (link.to == links[start].from) {
+                closed = true;
+                break;
+            }
+
+            double back = atan2(link.from.y - link.to.y, link.from.x - link.to.x);
+            auto first = std::lower_bound(order.begin(), order.end(), link.to, fromLess);
+            auto last = std::upper_bound(first, order.end(), link.to, lessFrom);
+            uint32_t next = UINT32_MAX;
+            double best = 0;
+            for (auto it = first; it != last; ++it) {
+                const Link& candidate = links[*it];
+                if (candidate.used) continue;
+                double turn = back - atan2(candidate.to.y - candidate.from.y, candidate.to.x - candidate.from.x);
+                while (turn <= 0) turn += 2 * PI;
+                while (turn > 2 * PI) turn -= 2 * PI;
+                if (next == UINT32_MAX || turn < best) {
+                    next = *it;
+                    best = turn;
+                }
+            }
+            if (next == UINT32_MAX) break;
+            current = next;
+        }
+        if (!closed) continue;
+
+        // 就近取整，去掉重复点和共线点
+        out.clear();
+        for (const PointD& p : ring) {
+            Point q((int)lrint(p.x), (int)lrint(p.y));
+            if (out.empty() || out.back() != q) out.push_back(q);
+            while (out.size() >= 3 && OrientInt(out[out.size() - 3], out[out.size() - 2], out.back()) == 0) {
+                out.erase(out.end() - 2);
+            }
+        }
+        while (out.size() >= 2 && out.front() == out.back()) out.pop_back();
+        while (out.size() >= 3) {
+            size_t n = out.size();
+            if (OrientInt(out[n - 2], out[n - 1], out[0]) == 0) {
+                out.pop_back();
+            } else if (OrientInt(out[n - 1], out[0], out[1]) == 0) {
+                out.erase(out.begin());
+            } else {
+                break;
+            }
+        }
+        if (out.size() >= 3) result.push_back(out);
+    }
+}
+
+void PolygonBoolean::GroupRings(const Rings& rings, std::vector<Rings>& polygons) {
+    polygons.clear();
+    std::vector<double> areas(rings.size());
+    std::vector<size_t> outers;
+    for (size_t i = 0; i < rings.size(); i++) {
+        areas[i] = SignedArea(rings[i]);
+        if (areas[i] > 0) {
+            outers.push_back(i);
+            polygons.push_back(Rings{ rings[i] });
+        }
+    }
+
+    for (size_t i = 0; i < rings.size(); i++) {
+        if (areas[i] > 0) continue;
+
+        // 结果环互不相交，洞的第一条边的中点在哪个外环内，整个洞就在哪个外环内
+        const std::vector<Point>& hole = rings[i];
+        double x = (hole[0].x + hole[1].x) / 2.0, y = (hole[0].y + hole[1].y) / 2.0;
+        size_t owner = SIZE_MAX;
+        for (size_t k = 0; k < outers.size(); k++) {
+            if ((owner == SIZE_MAX || areas[outers[k]] < areas[outers[owner]]) &&
+                RingContains(rings[outers[k]], x, y)) {
+                owner = k;
+            }
+        }
+        if (owner == SIZE_MAX) {
+            polygons.push_back(Rings{ hole });
+        } else {
+            polygons[owner].push_back(hole);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "Point.h"
+
+// 多边形布尔运算
+enum class BooleanOp {
+    Intersection,   // 交集 A ∩ B
+    Union,          // 并集 A ∪ B
+    Difference,     // 差集 A - B
+    Xor             // 异或（对称差）
+};
+
+// 扫描线多边形布尔运算引擎（Martinez 式）：
+//   1. 两个多边形的所有边一起按 x 扫描，找出相交、T 形接触和共线重叠，把边在这些点处切开，
+//      切开后的边之间只在端点处相接；
+//   2. 对切开的边再做一次扫描，每条边加入扫描线时由它下方的邻边递推出其下方区域分别在 A、B 内的奇偶性，
+//      两侧运算结果不同的边就是结果的边界，并定向为结果区域在左侧；
+//   3. 边界边在公共顶点处按最小转角连成闭合环。
+// 输入的每个多边形由若干环组成，按奇偶规则确定区域（与扫描线填充一致），因此凹多边形、自交多边形和洞都能处理。
+// 输入坐标为整数，相交检测用 64 位整数精确判断，交点用双精度保存，输出时就近取整。
+// 求交扫描中活动边按 y 分槽，只检查 y 范围落在同一槽中的边；分类扫描的扫描线状态是有序集合，
+// 每个事件 O(log n)，总代价为 O((n + k) log n)（n 为边数，k 为交点数）加上同槽内 y 范围不重叠的边对的检查。
+// 各阶段的数组在多次调用间复用。
+class PolygonBoolean {
+public:
+    typedef std::vector<std::vector<Point>> Rings;
+
+    // result = subject op clip。结果环的区域在前进方向的左侧（按 y 轴向上计算面积为正的是外环，为负的是洞）
+    void Compute(const Rings& subject, const Rings& clip, BooleanOp op, Rings& result);
+
+    // 把结果环按外环分组：polygons 的每一项是一个外环后跟位于它内部的洞。
+    // 洞归入包含它的面积最小的外环（岛中之洞归入岛）；找不到外环的洞单独成为一项
+    static void GroupRings(const Rings& rings, std::vector<Rings>& polygons);
+
+private:
+    struct PointD {
+        double x, y;
+        bool operator==(const PointD& o) const { return x == o.x && y == o.y; }
+        bool operator!=(const PointD& o) const { return !(*this == o); }
+    };
+
+    // 输入边（a 按 (x, y) 字典序小于 b）
+    struct Edge {
+        Point a, b;
+        uint8_t owner;      // 1 = subject，2 = clip
+    };
+
+    // 边上的切分点，key 为沿边的参数位置
+    struct Split {
+        uint32_t edge;
+        double key;
+        PointD p;
+    };
+
+    // 切开后的边
+    struct Piece {
+        PointD a, b;
+        uint8_t owner;      // 经过此边时奇偶性翻转的多边形（重合的边合并后按位异或）
+        uint8_t below;      // 边下方区域分别在 subject / clip 内的奇偶性
+    };
+
+    struct Event {
+        PointD p;
+        uint32_t piece;
+        bool left;          // 左端点（加入扫描线）或右端点（移出）
+    };
+
+    // 结果边界的有向边
+    struct Link {
+        PointD from, to;
+        bool used;
+    };
+
+    // 扫描线状态的次序：自下而上（比较时以左端点靠后的段为准，与另一段比较上下）
+    struct StatusLess {
+        const PolygonBoolean* engine;
+        bool operator()(uint32_t i, uint32_t j) const;
+    };
+    typedef std::set<uint32_t, StatusLess> Status;
+
+    static bool Less(const PointD& a, const PointD& b) { return a.x < b.x || (a.x == b.x && a.y < b.y); }
+    static double Orient(const PointD& a, const PointD& b, const PointD& c);
+
+    void AddRings(const Rings& rings, uint8_t owner);
+    // 找出所有边之间的切分点
+    void FindSplits();
+    void TestPair(uint32_t i, uint32_t j);
+    void AddSplit(uint32_t edge, const Point& q);
+    void AddSplit(uint32_t edge, double key, const PointD& p);
+    // 按切分点生成小段并合并重合的段
+    void BuildPieces();
+    // 扫描求各段两侧的奇偶性，选出结果的边界
+    void Classify(BooleanOp op);
+    // 活动段 t 是否在段 s 的下方（s 的左端点不在 t 之前，s 从 t 上的点出发时比较 s 的另一端）
+    bool Below(uint32_t t, const Piece& s) const;
+    // 把边界连成闭合环
+    void Connect(Rings& result);
+
+    std::vector<Edge> edges;
+    std::vector<uint32_t> order;
+    std::vector<std::vector<uint32_t>> slabs;   // 求交扫描的活动边，按 y 分槽存放
+    uint32_t slabCount = 0;
+    std::vector<Split> splits;
+    std::vector<Piece> pieces;
+    std::vector<Event> events;
+    Status status{ StatusLess{ this } };
+    std::vector<Status::iterator> statusPos;    // 各段在扫描线状态中的位置
+    std::vector<Link> links;
+    std::vector<PointD> ring;
+};
@@ -0,0 +1,163 @@
+#include "RasterTarget.h"
+#include "SpanWriter.h"
+#include <algorithm>
+
+// ============ RasterTarget 类实现 ============
+
+RasterTarget::RasterTarget()
+    : pixels(nullptr), width(0), height(0), stride(0), originX(0), originY(0) {}
+
+RasterTarget::RasterTarget(int width, int height)
+    : pixels(nullptr), width(0), height(0), stride(0), originX(0), originY(0) {
+    Resize(width, height);
+}
+
+RasterTarget::RasterTarget(uint32_t* pixels, int width, int height, int stride)
+    : pixels(nullptr), width(0), height(0), stride(0), originX(0), originY(0) {
+    Attach(pixels, width, height, stride);
+}
+
+void RasterTarget::Resize(int w, int h) {
+    if (w <= 0 || h <= 0) {
+        storage.clear();
+        pixels = nullptr;
+        width = height = stride = 0;
+        return;
+    }
+    storage.assign((size_t)w * h, 0);
+    pixels = storage.data();
+    width = w;
+    height = h;
+    stride = w;
+}
+
+void RasterTarget::Attach(uint32_t* p, int w, int h, int s) {
+    storage.clear();
+    pixels = p;
+    width = w;
+    height = h;
+    stride = s;
+}
+
+void RasterTarget::FillSpan(int x1, int x2, int y, uint32_t color) {
+    if ((unsigned)(y - originY) >= (unsigned)height) return;
+    if (x1 > x2) std::swap(x1, x2);
+    x1 = std::max(x1, originX);
+    x2 = std::min(x2, originX + width - 1);
+    if (x1 > x2) return;
+
+    SpanWriter::Fill(Row(y) + (x1 - originX), x2 - x1 + 1, color);
+}
+
+void RasterTarget::FillVerticalSpan(int x, int y1, int y2, uint32_t color) {
+    if ((unsigned)(x - originX) >= (unsigned)width) return;
+    if (y1 > y2) std::swap(y1, y2);
+    y1 = std::max(y1, originY);
+    y2 = std::min(y2, originY + height - 1);
+    if (y1 > y2) return;
+
+    uint32_t* p = Row(y1) + (x - originX);
+    for (int y = y1; y <= y2; y++, p += stride) {
+        *p = color;
+    }
+}
+
+void RasterTarget::BlendSpan(int x1, int x2, int y, uint32_t color, uint8_t alpha) {
+    if ((unsigned)(y - originY) >= (unsigned)height) return;
+    if (x1 > x2) std::swap(x1, x2);
+    x1 = std::max(x1, originX);
+    x2 = std::min(x2, originX + width - 1);
+    if (x1 > x2) return;
+
+    SpanWriter::Blend(Row(y) + (x1 - originX), x2 - x1 + 1, color, alpha);
+}
+
+void RasterTarget::Clear(uint32_t color) {
+    for (int y = originY; y < originY + height; y++) {
+        SpanWriter::Fill(Row(y), width, color);
+    }
+}
+
+#ifdef _WIN32
+// ============ HdcRaster 类实现 ============
+
+HdcRaster::HdcRaster(HDC hdc, const Rect& area)
+    : hdc(hdc), hdcTemp(NULL), hbmTemp(NULL), hbmOld(NULL) {
+    // 只处理 DC 当前裁剪框内的部分，避免超大坐标导致的巨大临时表面
+    RECT clipBox;
+    if (GetClipBox(hdc, &clipBox) == ERROR_REGION) return;
+    int left = std::max(area.left, (int)clipBox.left);
+    int top = std::max(area.top, (int)clipBox.top);
+    int right = std::min(area.right, (int)clipBox.right - 1);
+    int bottom = std::min(area.bottom, (int)clipBox.bottom - 1);
+    if (left > right || top > bottom) return;
+
+    // 快速路径：DC 中选入了 32bpp DIB 段，直接写其内存
+    HBITMAP hbm = (HBITMAP)GetCurrentObject(hdc, OBJ_BITMAP);
+    DIBSECTION ds;
+    if (hbm && GetObject(hbm, sizeof(ds), &ds) == sizeof(ds) &&
+        ds.dsBm.bmBitsPixel == 32 && ds.dsBm.bmBits != NULL) {
+        // 逻辑坐标 -> 设备坐标的平移
+        POINT viewportOrg, windowOrg;
+        GetViewportOrgEx(hdc, &viewportOrg);
+        GetWindowOrgEx(hdc, &windowOrg);
+        int offsetX = viewportOrg.x - windowOrg.x;
+        int offsetY = viewportOrg.y - windowOrg.y;
+
+        int dibWidth = ds.dsBm.bmWidth;
+        int dibHeight = ds.dsBm.bmHeight;
+        left = std::max(left, -offsetX);
+        top = std::max(top, -offsetY);
+        right = std::min(right, dibWidth - 1 - offsetX);
+        bottom = std::min(bottom, dibHeight - 1 - offsetY);
+        if (left > right || top > bottom) return;
+
+        // 先让之前排队的 GDI 绘制落到内存里
+        GdiFlush();
+
+        uint32_t* bits = (uint32_t*)ds.dsBm.bmBits;
+        int stride = ds.dsBm.bmWidthBytes / 4;
+        bool topDown = ds.dsBmih.biHeight < 0;
+        uint32_t* firstRow = topDown ? bits + (ptrdiff_t)(top + offsetY) * stride
+                                     : bits + (ptrdiff_t)(dibHeight - 1 - (top + offsetY)) * stride;
+        target.Attach(firstRow + left + offsetX, right - left + 1, bottom - top + 1,
+                      topDown ? stride : -stride);
+        target.SetOrigin(left, top);
+        return;
+    }
+
+    // 通用路径：拷贝到临时 DIB，析构时整体拷回
+    int w = right - left + 1;
+    int h = bottom - top + 1;
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = w;
+    bmi.bmiHeader.biHeight = -h;   // 自顶向下
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = NULL;
+    hbmTemp = CreateDIBSection(hdc, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!hbmTemp || !bits) return;
+    hdcTemp = CreateCompatibleDC(hdc);
+    hbmOld = SelectObject(hdcTemp, hbmTemp);
+    BitBlt(hdcTemp, 0, 0, w, h, hdc, left, top, SRCCOPY);
+    GdiFlush();
+
+    target.Attach((uint32_t*)bits, w, h, w);
+    target.SetOrigin(left, top);
+}
+
+HdcRaster::~HdcRaster() {
+    if (hdcTemp) {
+        BitBlt(hdc, target.OriginX(), target.OriginY(), target.Width(), target.Height(),
+               hdcTemp, 0, 0, SRCCOPY);
+        SelectObject(hdcTemp, hbmOld);
+        DeleteDC(hdcTemp);
+    }
+    if (hbmTemp) {
+        DeleteObject(hbmTemp);
+    }
+}
+#endif
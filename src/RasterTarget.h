@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Point.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+// 无窗口环境（Linux 无头构建）下补齐 GDI 的颜色类型，保持绘制接口不变
+typedef uint32_t COLORREF;
+#define RGB(r, g, b) ((COLORREF)(((uint8_t)(r)) | ((uint32_t)(uint8_t)(g) << 8) | ((uint32_t)(uint8_t)(b) << 16)))
+#define GetRValue(c) ((uint8_t)(c))
+#define GetGValue(c) ((uint8_t)((c) >> 8))
+#define GetBValue(c) ((uint8_t)((c) >> 16))
+#endif
+
+// 光栅目标：32位像素的内存表面（行指针 + 步长）
+// 像素格式为 0x00RRGGBB，与 32bpp DIB 的内存布局（B,G,R,X）一致
+// 所有坐标都是画布坐标，表面覆盖 [originX, originX + width) × [originY, originY + height)
+class RasterTarget {
+public:
+    RasterTarget();
+    // 分配自有内存的表面
+    RasterTarget(int width, int height);
+    // 包装外部内存（stride 以像素为单位，可以为负，用于自底向上的 DIB）
+    RasterTarget(uint32_t* pixels, int width, int height, int stride);
+
+    void Resize(int width, int height);
+    void Attach(uint32_t* pixels, int width, int height, int stride);
+    void SetOrigin(int x, int y) { originX = x; originY = y; }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+    int Stride() const { return stride; }
+    int OriginX() const { return originX; }
+    int OriginY() const { return originY; }
+    bool IsEmpty() const { return pixels == nullptr || width <= 0 || height <= 0; }
+    // 表面覆盖的画布区域（包含边界）
+    Rect Bounds() const { return Rect(originX, originY, originX + width - 1, originY + height - 1); }
+
+    // 第 y 行（画布坐标）起始像素的指针，对应 x = originX
+    uint32_t* Row(int y) { return pixels + (ptrdiff_t)(y - originY) * stride; }
+    const uint32_t* Row(int y) const { return pixels + (ptrdiff_t)(y - originY) * stride; }
+
+    bool Contains(int x, int y) const {
+        return (unsigned)(x - originX) < (unsigned)width && (unsigned)(y - originY) < (unsigned)height;
+    }
+
+    // 写单个像素，超出表面的像素被丢弃
+    void SetPixel(int x, int y, uint32_t color) {
+        if (Contains(x, y)) Row(y)[x - originX] = color;
+    }
+    uint32_t GetPixel(int x, int y) const {
+        return Contains(x, y) ? Row(y)[x - originX] : 0;
+    }
+
+    // 填充水平像素段 [x1, x2]（包含两端），自动裁剪到表面
+    void FillSpan(int x1, int x2, int y, uint32_t color);
+    // 填充竖直像素段 [y1, y2]（包含两端），自动裁剪到表面
+    void FillVerticalSpan(int x, int y1, int y2, uint32_t color);
+    // 以 alpha（0~255）把颜色混合到水平像素段上
+    void BlendSpan(int x1, int x2, int y, uint32_t color, uint8_t alpha);
+    void Clear(uint32_t color);
+
+    // COLORREF（0x00BBGGRR）与像素格式（0x00RRGGBB）的转换
+    static uint32_t ToPixel(COLORREF color) {
+        return ((uint32_t)GetRValue(color) << 16) | ((uint32_t)GetGValue(color) << 8) | GetBValue(color);
+    }
+    static COLORREF ToColorRef(uint32_t pixel) {
+        return RGB((pixel >> 16) & 0xFF, (pixel >> 8) & 0xFF, pixel & 0xFF);
+    }
+
+private:
+    std::vector<uint32_t> storage;   // 自有内存（包装外部内存时为空）
+    uint32_t* pixels;
+    int width;
+    int height;
+    int stride;
+    int originX;
+    int originY;
+};
+
+#ifdef _WIN32
+// HDC 与光栅目标之间的桥接（RAII）
+// 如果 DC 中选入的是 32bpp DIB 段（例如窗口的双缓冲），直接在其内存上光栅化；
+// 否则把受影响的区域拷贝到临时 DIB，光栅化完成后在析构时再整体 BitBlt 回 DC。
+class HdcRaster {
+public:
+    // area：本次绘制可能触及的画布区域（包含边界）
+    HdcRaster(HDC hdc, const Rect& area);
+    ~HdcRaster();
+
+    RasterTarget& Target() { return target; }
+    bool IsEmpty() const { return target.IsEmpty(); }
+
+private:
+    HDC hdc;
+    HDC hdcTemp;
+    HBITMAP hbmTemp;
+    HGDIOBJ hbmOld;
+    RasterTarget target;
+
+    HdcRaster(const HdcRaster&) = delete;
+    HdcRaster& operator=(const HdcRaster&) = delete;
+};
+#endif
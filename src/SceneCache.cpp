@@ -0,0 +1,106 @@
+#include "SceneCache.h"
+#include "RasterTarget.h"
+#include <algorithm>
+
+SceneCache::SceneCache()
+    : hdcCache(NULL), hbmCache(NULL), hbmOld(NULL), bits(nullptr), width(0), height(0) {}
+
+SceneCache::~SceneCache() {
+    Release();
+}
+
+void SceneCache::Release() {
+    if (hdcCache) {
+        SelectObject(hdcCache, hbmOld);
+        DeleteDC(hdcCache);
+    }
+    if (hbmCache) {
+        DeleteObject(hbmCache);
+    }
+    hdcCache = NULL;
+    hbmCache = NULL;
+    hbmOld = NULL;
+    bits = nullptr;
+    width = height = 0;
+    dirty.AddAll();
+}
+
+void SceneCache::Resize(HDC reference, int w, int h) {
+    if (w == width && h == height && hdcCache) return;
+
+    Release();
+    if (w <= 0 || h <= 0) return;
+
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = w;
+    bmi.bmiHeader.biHeight = -h;   // 自顶向下
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    void* pixels = NULL;
+    hbmCache = CreateDIBSection(reference, &bmi, DIB_RGB_COLORS, &pixels, NULL, 0);
+    if (!hbmCache || !pixels) {
+        Release();
+        return;
+    }
+    hdcCache = CreateCompatibleDC(reference);
+    hbmOld = SelectObject(hdcCache, hbmCache);
+    bits = (uint32_t*)pixels;
+    width = w;
+    height = h;
+}
+
+void SceneCache::TakeDirty(std::vector<Rect>& regions) {
+    regions.clear();
+    if (!hdcCache) return;
+
+    Rect bounds = Bounds();
+    if (dirty.IsFull()) {
+        regions.push_back(bounds);
+    } else {
+        for (const auto& r : dirty.Rects()) {
+            if (!r.Intersects(bounds)) continue;
+            regions.push_back(Rect(std::max(r.left, 0), std::max(r.top, 0),
+                                   std::min(r.right, width - 1), std::min(r.bottom, height - 1)));
+        }
+    }
+    dirty.Clear();
+}
+
+HDC SceneCache::BeginRegion(const Rect& area) {
+    if (!hdcCache) return NULL;
+
+    // 清成白色背景（直接写 DIB 内存）
+    GdiFlush();
+    RasterTarget target(bits + (ptrdiff_t)area.top * width + area.left,
+                        area.right - area.left + 1, area.bottom - area.top + 1, width);
+    target.Clear(0xFFFFFF);
+
+    // GDI 绘制与软件光栅化（HdcRaster 按裁剪框取表面）都限制在该区域内
+    SaveDC(hdcCache);
+    IntersectClipRect(hdcCache, area.left, area.top, area.right + 1, area.bottom + 1);
+    return hdcCache;
+}
+
+void SceneCache::EndRegion() {
+    if (hdcCache) {
+        RestoreDC(hdcCache, -1);
+    }
+}
+
+long long SceneCache::Present(HDC hdc) const {
+    if (!hdcCache) return 0;
+
+    RECT clipBox;
+    if (GetClipBox(hdc, &clipBox) == ERROR_REGION) return 0;
+    int left = std::max((int)clipBox.left, 0);
+    int top = std::max((int)clipBox.top, 0);
+    int right = std::min((int)clipBox.right, width);
+    int bottom = std::min((int)clipBox.bottom, height);
+    if (left >= right || top >= bottom) return 0;
+
+    BitBlt(hdc, left, top, right - left, bottom - top, hdcCache, left, top, SRCCOPY);
+    return (long long)(right - left) * (bottom - top);
+}
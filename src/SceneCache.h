@@ -0,0 +1,49 @@
+#pragma once
+#include <windows.h>
+#include <cstdint>
+#include <vector>
+#include "Point.h"
+#include "DamageRegion.h"
+
+// 已提交图形的缓存位图（32bpp 自顶向下 DIB 段，含白色背景）
+// 图形列表或图形本身变化时只把受影响的区域标记为失效，下次绘制前按区域重建；
+// 平时每帧只需把它复制到后备缓冲，再叠加预览层。
+class SceneCache {
+public:
+    SceneCache();
+    ~SceneCache();
+
+    // 调整到 width × height（与窗口客户区一致），尺寸变化时重新分配并整体失效
+    void Resize(HDC reference, int width, int height);
+
+    void Invalidate() { dirty.AddAll(); }
+    void Invalidate(const Rect& area) { dirty.Add(area); }
+    bool IsValid() const { return dirty.IsEmpty(); }
+    bool IsEmpty() const { return hdcCache == NULL; }
+    // 缓存覆盖的画布区域（包含边界）
+    Rect Bounds() const { return Rect(0, 0, width - 1, height - 1); }
+
+    // 取出需要重建的区域（已裁剪到缓存范围），之后缓存视为有效
+    void TakeDirty(std::vector<Rect>& regions);
+    // 重建一个区域：先清成白色背景，并把缓存 DC 的裁剪区设为该区域，返回缓存的 DC；
+    // 画完后调用 EndRegion
+    HDC BeginRegion(const Rect& area);
+    void EndRegion();
+
+    // 把缓存复制到 hdc 的同一位置（只复制 hdc 裁剪框内的部分），返回复制的像素数
+    long long Present(HDC hdc) const;
+
+private:
+    void Release();
+
+    HDC hdcCache;
+    HBITMAP hbmCache;
+    HGDIOBJ hbmOld;
+    uint32_t* bits;
+    int width;
+    int height;
+    DamageRegion dirty;
+
+    SceneCache(const SceneCache&) = delete;
+    SceneCache& operator=(const SceneCache&) = delete;
+};
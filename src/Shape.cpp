@@ -1,19 +1,28 @@
 ﻿#include "Shape.h"
 #include <cmath>
+#include "AffineTransform.h"
+#include "SplineTessellator.h"
 
 // ============ Line 类实现 ============
 Line::Line(LineAlgorithm algo)
     : hasStart(false), complete(false), algorithm(algo), start(0, 0), end(0, 0), previewEnd(0, 0) {}
 
+// 根据算法选择不同颜色
+COLORREF Line::GetColor() const {
+    if (algorithm == LineAlgorithm::Midpoint) {
+        return RGB(255, 0, 0);  // 中点法 - 红色
+    } else if (algorithm == LineAlgorithm::Bresenham) {
+        return RGB(0, 0, 255);  // Bresenham - 蓝色
+    } else if (algorithm == LineAlgorithm::RunSlice) {
+        return RGB(0, 128, 128);  // 游程切片 - 青色
+    }
+    return RGB(0, 0, 0);  // GDI - 黑色
+}
+
 void Line::Draw(HDC hdc) {
+    EnsureGeometry();
     if (complete) {
-        // 根据算法选择不同颜色
-        COLORREF color = RGB(0, 0, 0);  // GDI - 黑色
-        if (algorithm == LineAlgorithm::Midpoint) {
-            color = RGB(255, 0, 0);  // 中点法 - 红色
-        } else if (algorithm == LineAlgorithm::Bresenham) {
-            color = RGB(0, 0, 255);  // Bresenham - 蓝色
-        }
+        COLORREF color = GetColor();
         
         // 如果被选中，使用更粗的线条
         if (isSelected) {
@@ -30,6 +39,7 @@ void Line::Draw(HDC hdc) {
 }
 
 void Line::DrawPreview(HDC hdc) {
+    EnsureGeometry();
     // 只有在已经有起点且预览点已设置时才绘制预览虚线
     if (hasStart && !complete && (previewEnd.x != 0 || previewEnd.y != 0)) {
         HPEN hPen = CreatePen(PS_DOT, 1, RGB(128, 128, 128));
@@ -46,19 +56,21 @@ bool Line::IsComplete() const {
 }
 
 void Line::AddPoint(const Point& p) {
+    InvalidateGeometry();
     if (!hasStart) {
-        start = p;
+        ends[0] = p;
         hasStart = true;
         // 第一次点击时，不设置预览点，避免出现从原点到起点的虚线
-        previewEnd = start;
+        previewEnd = p;
     }
     else if (!complete) {
-        end = p;
+        ends[1] = p;
         complete = true;
     }
 }
 
 void Line::SetPreviewPoint(const Point& p) {
+    InvalidateBounds();
     if (hasStart && !complete) {
         previewEnd = p;
     }
@@ -70,7 +82,8 @@ void Line::SetAlgorithm(LineAlgorithm algo) {
 
 // ============ Circle 类实现 ============
 Circle::Circle(CircleAlgorithm algo)
-    : radius(0), hasCenter(false), complete(false), algorithm(algo), center(0, 0), previewPoint(0, 0) {}
+    : origin(0, 0), baseRadius(0), radiusScale(1.0), center(0, 0), radius(0),
+      hasCenter(false), complete(false), algorithm(algo), previewPoint(0, 0) {}
 
 int Circle::CalculateRadius(const Point& p1, const Point& p2) {
     int dx = p2.x - p1.x;
@@ -78,15 +91,20 @@ int Circle::CalculateRadius(const Point& p1, const Point& p2) {
     return (int)sqrt(dx * dx + dy * dy);
 }
 
+// 根据算法选择不同颜色
+COLORREF Circle::GetColor() const {
+    if (algorithm == CircleAlgorithm::Midpoint) {
+        return RGB(255, 0, 0);  // 中点法 - 红色
+    } else if (algorithm == CircleAlgorithm::Bresenham) {
+        return RGB(0, 0, 255);  // Bresenham - 蓝色
+    }
+    return RGB(0, 0, 0);  // GDI - 黑色
+}
+
 void Circle::Draw(HDC hdc) {
+    EnsureGeometry();
     if (complete && radius > 0) {
-        // 根据算法选择不同颜色
-        COLORREF color = RGB(0, 0, 0);  // GDI - 黑色
-        if (algorithm == CircleAlgorithm::Midpoint) {
-            color = RGB(255, 0, 0);  // 中点法 - 红色
-        } else if (algorithm == CircleAlgorithm::Bresenham) {
-            color = RGB(0, 0, 255);  // Bresenham - 蓝色
-        }
+        COLORREF color = GetColor();
         
         // 如果被选中，绘制高亮边框
         if (isSelected) {
@@ -106,6 +124,7 @@ void Circle::Draw(HDC hdc) {
 }
 
 void Circle::DrawPreview(HDC hdc) {
+    EnsureGeometry();
     if (hasCenter && !complete && (previewPoint.x != center.x || previewPoint.y != center.y)) {
         int r = CalculateRadius(center, previewPoint);
         if (r > 0) {
@@ -126,19 +145,21 @@ bool Circle::IsComplete() const {
 }
 
 void Circle::AddPoint(const Point& p) {
+    InvalidateGeometry();
     if (!hasCenter) {
-        center = p;
+        origin = p;
         hasCenter = true;
         // 第一次点击时，预览点设为中心点，避免出现半径为0的圆
-        previewPoint = center;
+        previewPoint = p;
     }
     else if (!complete) {
-        radius = CalculateRadius(center, p);
+        baseRadius = CalculateRadius(origin, p);
         complete = true;
     }
 }
 
 void Circle::SetPreviewPoint(const Point& p) {
+    InvalidateBounds();
     if (hasCenter && !complete) {
         previewPoint = p;
     }
@@ -149,17 +170,20 @@ void Circle::SetAlgorithm(CircleAlgorithm algo) {
 }
 
 Point Circle::GetCenter() const {
+    EnsureGeometry();
     return center;
 }
 
 int Circle::GetRadius() const {
+    EnsureGeometry();
     return radius;
 }
 
 // ============ Rectangle 类实现 ============
-Rectangle::Rectangle() : hasFirstPoint(false), complete(false), topLeft(0, 0), bottomRight(0, 0), previewPoint(0, 0) {}
+Rectangle::Rectangle() : topLeft(0, 0), bottomRight(0, 0), hasFirstPoint(false), complete(false), previewPoint(0, 0) {}
 
 void Rectangle::Draw(HDC hdc) {
+    EnsureGeometry();
     if (complete) {
         int penWidth = isSelected ? 3 : 1;
         COLORREF penColor = isSelected ? RGB(255, 0, 255) : RGB(0, 0, 0);
@@ -175,6 +199,7 @@ void Rectangle::Draw(HDC hdc) {
 }
 
 void Rectangle::DrawPreview(HDC hdc) {
+    EnsureGeometry();
     if (hasFirstPoint && !complete && (previewPoint.x != topLeft.x || previewPoint.y != topLeft.y)) {
         HPEN hPen = CreatePen(PS_DOT, 1, RGB(128, 128, 128));
         HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
@@ -192,29 +217,33 @@ bool Rectangle::IsComplete() const {
 }
 
 void Rectangle::AddPoint(const Point& p) {
+    InvalidateGeometry();
     if (!hasFirstPoint) {
-        topLeft = p;
+        corners[0] = p;
         hasFirstPoint = true;
         // 第一次点击时，预览点设为起点，避免出现从原点到起点的矩形
-        previewPoint = topLeft;
+        previewPoint = p;
     }
     else if (!complete) {
-        bottomRight = p;
+        corners[1] = p;
         complete = true;
     }
 }
 
 void Rectangle::SetPreviewPoint(const Point& p) {
+    InvalidateBounds();
     if (hasFirstPoint && !complete) {
         previewPoint = p;
     }
 }
 
 Point Rectangle::GetTopLeft() const {
+    EnsureGeometry();
     return topLeft;
 }
 
 Point Rectangle::GetBottomRight() const {
+    EnsureGeometry();
     return bottomRight;
 }
 
@@ -222,26 +251,15 @@ Point Rectangle::GetBottomRight() const {
 Polyline::Polyline() : closed(false) {}
 
 void Polyline::Draw(HDC hdc) {
+    EnsureGeometry();
     if (points.size() < 2) return;
 
     int penWidth = isSelected ? 3 : 1;
     COLORREF penColor = isSelected ? RGB(255, 0, 255) : RGB(0, 0, 0);
-    HPEN hPen = CreatePen(PS_SOLID, penWidth, penColor);
-    HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
-
-    for (size_t i = 0; i < points.size() - 1; i++) {
-        MoveToEx(hdc, points[i].x, points[i].y, NULL);
-        LineTo(hdc, points[i + 1].x, points[i + 1].y);
-    }
-
-    // 如果封闭,连接最后一个点和第一个点
-    if (closed && points.size() > 2) {
-        MoveToEx(hdc, points.back().x, points.back().y, NULL);
-        LineTo(hdc, points[0].x, points[0].y);
-    }
 
-    SelectObject(hdc, hOldPen);
-    DeleteObject(hPen);
+    // 一次调用画完所有线段；如果封闭,再连接最后一个点和第一个点
+    DrawingAlgorithm::DrawPolyline(hdc, points, closed && points.size() > 2,
+                                   LineAlgorithm::GDI, penColor, penWidth);
 }
 
 void Polyline::DrawPreview(HDC hdc) {
@@ -253,7 +271,8 @@ bool Polyline::IsComplete() const {
 }
 
 void Polyline::AddPoint(const Point& p) {
-    points.push_back(p);
+    InvalidateGeometry();
+    basePoints.push_back(p);
 }
 
 void Polyline::SetPreviewPoint(const Point& p) {
@@ -261,180 +280,196 @@ void Polyline::SetPreviewPoint(const Point& p) {
 }
 
 void Polyline::Close() {
-    if (points.size() >= 3) {
+    if (basePoints.size() >= 3) {
         closed = true;
     }
 }
 
 const std::vector<Point>& Polyline::GetPoints() const {
+    EnsureGeometry();
     return points;
 }
 
 size_t Polyline::GetPointCount() const {
-    return points.size();
+    return basePoints.size();
 }
 
 // ============ BSpline 类实现 ============
-BSpline::BSpline(int minPts) : complete(false), minPoints(minPts) {}
+BSpline::BSpline(int minPts) : previewPoint(0, 0), complete(false), minPoints(minPts) {}
+
+BSpline::BSpline(int deg, KnotType type)
+    : degree(deg < 1 ? 1 : deg), knotType(type), previewPoint(0, 0), complete(false), minPoints(degree + 1) {}
+
+void BSpline::BuildNurbs(const std::vector<Point>& points, NurbsCurve& nurbs) const {
+    std::vector<double> knotVector;
+    switch (knotType) {
+    case KnotType::Uniform:
+        NurbsCurve::UniformKnots(degree, points.size(), knotVector);
+        break;
+    case KnotType::Clamped:
+        NurbsCurve::ClampedKnots(degree, points.size(), knotVector);
+        break;
+    case KnotType::Custom:
+        knotVector = knots;
+        break;
+    }
+    nurbs.Set(degree, points, knotVector, weights);
+}
 
-// 使用4个控制点和参数t计算B样条曲线上的点
-// t的范围是[0,1],对应一段曲线段
-Point BSpline::CalculateCurvePoint(const Point& p0, const Point& p1, const Point& p2, const Point& p3, double t) {
-    // 三次均匀B样条基函数
-    double f1 = (-t*t*t + 3*t*t - 3*t + 1) / 6.0;
-    double f2 = (3*t*t*t - 6*t*t + 4) / 6.0;
-    double f3 = (-3*t*t*t + 3*t*t + 3*t + 1) / 6.0;
-    double f4 = (t*t*t) / 6.0;
+void BSpline::SetWeights(const std::vector<double>& w) {
+    weights = w;
+    InvalidateCurve();
+    InvalidateBounds();
+}
+
+void BSpline::SetKnots(const std::vector<double>& k) {
+    knots = k;
+    knotType = KnotType::Custom;
+    InvalidateCurve();
+    InvalidateBounds();
+}
+
+// 等分数由平直度容差决定（屏幕上越大、越弯的段点越多），每段用前向差分细分
+void BSpline::TessellateSegment(const Point* cp, std::vector<Point>& out) {
+    SplineTessellator::TessellateCubicAdaptive(cp, FLATNESS, out);
+}
+
+void BSpline::UpdateCurve() const {
+    EnsureGeometry();
+    size_t total = controlPoints.size() > (size_t)degree ? controlPoints.size() - degree : 0;
+    if (curveEnds.size() > total) {
+        InvalidateCurve();
+    }
+    if (curveEnds.size() == total) return;
     
-    double x = f1 * p0.x + f2 * p1.x + f3 * p2.x + f4 * p3.x;
-    double y = f1 * p0.y + f2 * p1.y + f3 * p2.y + f4 * p3.y;
+    if (IsUniformCubic()) {
+        // 每4个连续的控制点生成一段曲线，已经算好的段保持不变
+        while (curveEnds.size() < total) {
+            size_t k = curveEnds.size();
+            // 连接点只保留一份：去掉上一段的终点，由本段的起点代替
+            if (k > 0) curve.pop_back();
+            TessellateSegment(&controlPoints[k], curve);
+            curveEnds.push_back(curve.size() - 1);
+        }
+        return;
+    }
     
-    return Point((int)(x + 0.5), (int)(y + 0.5));
+    // 一般情形：de Boor 批量求值，每段按容差等分。
+    // 均匀节点下增加控制点不改变已有的节点，只把新的控制点和节点追加到缓存的曲线上；
+    // 节点会整体变化的情形（其他节点类型、权重或节点被修改、变换）已由 InvalidateCurve 清空曲线，在这里重建
+    if (nurbs.IsEmpty()) {
+        BuildNurbs(controlPoints, nurbs);
+    } else if (knotType == KnotType::Uniform) {
+        while (nurbs.PointCount() < controlPoints.size()) {
+            size_t i = nurbs.PointCount();
+            if (!nurbs.Append(controlPoints[i], weights.empty() ? 1.0 : weights[i], nurbs.LastKnot() + 1.0)) break;
+        }
+    }
+    if (nurbs.SpanCount() != total) {
+        // 节点或权重与控制点个数不符，不画曲线
+        InvalidateCurve();
+        return;
+    }
+    while (curveEnds.size() < total) {
+        size_t k = curveEnds.size();
+        if (nurbs.StepsForTolerance(k, FLATNESS) == 0) {
+            // 长度为 0 的节点区间：不产生新点
+            if (curve.empty()) curve.push_back(nurbs.Evaluate(nurbs.SpanStart(k)));
+        } else {
+            if (!curve.empty()) curve.pop_back();
+            nurbs.TessellateSpan(k, FLATNESS, curve);
+        }
+        curveEnds.push_back(curve.size() - 1);
+    }
 }
 
 void BSpline::Draw(HDC hdc) {
+    EnsureGeometry();
     if (controlPoints.size() < minPoints) return;
 
     // 绘制控制多边形(虚线,灰色)
-    HPEN hPenDot = CreatePen(PS_DOT, 1, RGB(200, 200, 200));
-    HPEN hOldPen = (HPEN)SelectObject(hdc, hPenDot);
-    for (size_t i = 0; i < controlPoints.size() - 1; i++) {
-        MoveToEx(hdc, controlPoints[i].x, controlPoints[i].y, NULL);
-        LineTo(hdc, controlPoints[i + 1].x, controlPoints[i + 1].y);
-    }
-    SelectObject(hdc, hOldPen);
-    DeleteObject(hPenDot);
+    DrawingAlgorithm::DrawPolyline(hdc, controlPoints, false, LineAlgorithm::GDI,
+                                   RGB(200, 200, 200), 1, PS_DOT);
 
     // 绘制控制点(小黑圆)
-    HBRUSH hBrush = CreateSolidBrush(RGB(0, 0, 0));
-    HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hBrush);
     for (const auto& p : controlPoints) {
-        Ellipse(hdc, p.x - 3, p.y - 3, p.x + 3, p.y + 3);
+        DrawingAlgorithm::FillCircle(hdc, p.x, p.y, 3, RGB(0, 0, 0));
     }
-    SelectObject(hdc, hOldBrush);
-    DeleteObject(hBrush);
-
-    // 如果控制点少于4个,不绘制曲线
-    if (controlPoints.size() < 4) return;
-
-    // 绘制平滑的B样条曲线(红色)
-    HPEN hPenCurve = CreatePen(PS_SOLID, 2, RGB(255, 0, 0));
-    hOldPen = (HPEN)SelectObject(hdc, hPenCurve);
 
-    // 每4个连续的控制点生成一段曲线
-    const int segments = 20;  // 每段曲线的细分数
-    bool firstPoint = true;
-    
-    curvePoints.clear();
-    
-    for (size_t i = 0; i + 3 < controlPoints.size(); i++) {
-        // 对每一段进行细分
-        for (int j = 0; j <= segments; j++) {
-            double t = (double)j / segments;
-            Point p = CalculateCurvePoint(controlPoints[i], controlPoints[i + 1], 
-                                         controlPoints[i + 2], controlPoints[i + 3], t);
-            
-            // 记录曲线点用于标记
-            if (j == segments) { 
-                curvePoints.push_back(p);
-            }
-            
-            if (firstPoint) {
-                MoveToEx(hdc, p.x, p.y, NULL);
-                firstPoint = false;
-            } else {
-                LineTo(hdc, p.x, p.y);
-            }
-        }
-    }
+    // 如果控制点少于 degree + 1 个（三次时为4个）,不绘制曲线
+    if (controlPoints.size() < (size_t)degree + 1) return;
 
-    SelectObject(hdc, hOldPen);
-    DeleteObject(hPenCurve);
+    // 绘制平滑的B样条曲线(红色)，整条曲线一次画完；曲线来自缓存，空闲重绘时不做曲线计算
+    UpdateCurve();
+    DrawingAlgorithm::DrawPolyline(hdc, curve, false, LineAlgorithm::GDI, RGB(255, 0, 0), 2);
 
-    // 绘制曲线标记点(绿色圆圈)
-    HPEN hPenGreen = CreatePen(PS_SOLID, 1, RGB(0, 255, 0));
-    hOldPen = (HPEN)SelectObject(hdc, hPenGreen);
-    HBRUSH hBrushGreen = CreateSolidBrush(RGB(0, 255, 0));
-    hOldBrush = (HBRUSH)SelectObject(hdc, hBrushGreen);
-    for (const auto& p : curvePoints) {
-        Ellipse(hdc, p.x - 4, p.y - 4, p.x + 4, p.y + 4);
+    // 绘制曲线标记点(绿色圆圈)：每段曲线的终点
+    for (size_t k = 0; k < curveEnds.size(); k++) {
+        const Point& p = SegmentEnd(k);
+        DrawingAlgorithm::FillCircle(hdc, p.x, p.y, 4, RGB(0, 255, 0));
     }
-    SelectObject(hdc, hOldBrush);
-    DeleteObject(hBrushGreen);
-    SelectObject(hdc, hOldPen);
-    DeleteObject(hPenGreen);
 }
 
 void BSpline::DrawPreview(HDC hdc) {
+    EnsureGeometry();
     // 绘制已有的控制点
     if (controlPoints.size() > 0) {
         // 绘制控制点(小黑圆)
-        HBRUSH hBrush = CreateSolidBrush(RGB(0, 0, 0));
-        HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hBrush);
         for (const auto& p : controlPoints) {
-            Ellipse(hdc, p.x - 3, p.y - 3, p.x + 3, p.y + 3);
+            DrawingAlgorithm::FillCircle(hdc, p.x, p.y, 3, RGB(0, 0, 0));
         }
-        SelectObject(hdc, hOldBrush);
-        DeleteObject(hBrush);
         
         // 绘制控制多边形(虚线)
         if (controlPoints.size() > 1) {
-            HPEN hPenDot = CreatePen(PS_DOT, 1, RGB(200, 200, 200));
-            HPEN hOldPen = (HPEN)SelectObject(hdc, hPenDot);
-            for (size_t i = 0; i < controlPoints.size() - 1; i++) {
-                MoveToEx(hdc, controlPoints[i].x, controlPoints[i].y, NULL);
-                LineTo(hdc, controlPoints[i + 1].x, controlPoints[i + 1].y);
-            }
-            SelectObject(hdc, hOldPen);
-            DeleteObject(hPenDot);
+            DrawingAlgorithm::DrawPolyline(hdc, controlPoints, false, LineAlgorithm::GDI,
+                                           RGB(200, 200, 200), 1, PS_DOT);
         }
     }
 
-    // 如果有足够的点(>=4),绘制部分曲线
-    if (controlPoints.size() >= 4) {
+    // 如果有足够的点(三次时>=4),绘制部分曲线
+    if (controlPoints.size() >= (size_t)degree + 1) {
+        UpdateCurve();
+
         // 绘制平滑的预览曲线
-        HPEN hPenCurve = CreatePen(PS_SOLID, 2, RGB(255, 0, 0));
-        HPEN hOldPen = (HPEN)SelectObject(hdc, hPenCurve);
+        DrawingAlgorithm::DrawPolyline(hdc, curve, false, LineAlgorithm::GDI, RGB(255, 0, 0), 2);
 
-        const int segments = 20;
-        bool firstPoint = true;
-        std::vector<Point> previewCurvePoints;
-        
-        for (size_t i = 0; i + 3 < controlPoints.size(); i++) {
-            for (int j = 0; j <= segments; j++) {
-                double t = (double)j / segments;
-                Point p = CalculateCurvePoint(controlPoints[i], controlPoints[i + 1], 
-                                             controlPoints[i + 2], controlPoints[i + 3], t);
-                
-                if (j == segments / 2) {
-                    previewCurvePoints.push_back(p);
-                }
-                
-                if (firstPoint) {
-                    MoveToEx(hdc, p.x, p.y, NULL);
-                    firstPoint = false;
-                } else {
-                    LineTo(hdc, p.x, p.y);
-                }
-            }
+        // 绘制标记点(绿色)：每段曲线的中点
+        for (size_t k = 0; k < curveEnds.size(); k++) {
+            const Point& p = SegmentMiddle(k);
+            DrawingAlgorithm::FillCircle(hdc, p.x, p.y, 4, RGB(0, 255, 0));
         }
+    }
 
-        SelectObject(hdc, hOldPen);
-        DeleteObject(hPenCurve);
-
-        // 绘制标记点(绿色)
-        if (previewCurvePoints.size() > 0) {
-            HPEN hPenGreen = CreatePen(PS_SOLID, 1, RGB(0, 255, 0));
-            hOldPen = (HPEN)SelectObject(hdc, hPenGreen);
-            HBRUSH hBrushGreen = CreateSolidBrush(RGB(0, 255, 0));
-            HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hBrushGreen);
-            for (const auto& p : previewCurvePoints) {
-                Ellipse(hdc, p.x - 4, p.y - 4, p.x + 4, p.y + 4);
+    // 预览控制点：连到最后一个控制点，并只临时细分它参与的最后一段曲线
+    if (hasPreview && !controlPoints.empty()) {
+        const Point& last = controlPoints.back();
+        std::vector<Point> rubberBand = { last, previewPoint };
+        DrawingAlgorithm::DrawPolyline(hdc, rubberBand, false, LineAlgorithm::GDI,
+                                       RGB(200, 200, 200), 1, PS_DOT);
+        size_t n = controlPoints.size();
+        std::vector<Point> segment;
+        if (IsUniformCubic() && n >= 3) {
+            Point cp[4] = { controlPoints[n - 3], controlPoints[n - 2], controlPoints[n - 1], previewPoint };
+            TessellateSegment(cp, segment);
+        } else if (knotType == KnotType::Uniform && n >= (size_t)degree) {
+            // 均匀节点：末尾一段只由最后 degree 个控制点和预览点决定
+            std::vector<Point> tail(controlPoints.end() - degree, controlPoints.end());
+            tail.push_back(previewPoint);
+            std::vector<double> tailWeights;
+            if (!weights.empty() && weights.size() >= (size_t)degree) {
+                tailWeights.assign(weights.end() - degree, weights.end());
+                tailWeights.push_back(1.0);
+            }
+            std::vector<double> tailKnots;
+            NurbsCurve::UniformKnots(degree, tail.size(), tailKnots);
+            NurbsCurve nurbs;
+            if (nurbs.Set(degree, tail, tailKnots, tailWeights)) {
+                nurbs.TessellateSpan(0, FLATNESS, segment);
             }
-            SelectObject(hdc, hOldBrush);
-            DeleteObject(hBrushGreen);
-            SelectObject(hdc, hOldPen);
-            DeleteObject(hPenGreen);
+        }
+        // 其他节点类型中新控制点会改变整条曲线，预览时只画控制多边形
+        if (segment.size() >= 2) {
+            DrawingAlgorithm::DrawPolyline(hdc, segment, false, LineAlgorithm::GDI, RGB(255, 0, 0), 2);
         }
     }
 }
@@ -444,28 +479,44 @@ bool BSpline::IsComplete() const {
 }
 
 void BSpline::AddPoint(const Point& p) {
-    controlPoints.push_back(p);
+    InvalidateBounds();
+    baseControlPoints.push_back(p);
+    if (!weights.empty()) weights.push_back(1.0);
+    // 非均匀节点随控制点个数变化，整条曲线都要重新细分
+    if (knotType != KnotType::Uniform) InvalidateCurve();
+    if (IsGeometryValid()) {
+        // 设备坐标缓存仍有效：只映射新的控制点，已细分的曲线段不受影响
+        Point device;
+        AffineTransform::Map(&p, &device, 1, transform);
+        controlPoints.push_back(device);
+    }
 }
 
 void BSpline::SetPreviewPoint(const Point& p) {
-    // B样条不需要预览点
+    if (complete || baseControlPoints.empty()) return;
+    InvalidateBounds();
+    previewPoint = p;
+    hasPreview = true;
 }
 
 void BSpline::Finish() {
+    InvalidateBounds();
     complete = true;
+    hasPreview = false;
 }
 
 size_t BSpline::GetPointCount() const {
-    return controlPoints.size();
+    return baseControlPoints.size();
 }
 
 // ============ FilledRegion 类实现 ============
-FilledRegion::FilledRegion(const std::vector<Point>& pts, FillAlgorithm algo, COLORREF color)
-    : points(pts), algorithm(algo), complete(true), fillColor(color) {}
+FilledRegion::FilledRegion(const std::vector<Point>& pts, FillAlgorithm algo, COLORREF color,
+                           const std::vector<std::vector<Point>>& holeRings)
+    : points(pts), holes(holeRings), algorithm(algo), complete(true), fillColor(color) {}
 
 void FilledRegion::Draw(HDC hdc) {
     if (points.size() >= 3) {
-        DrawingAlgorithm::FillPolygon(hdc, points, algorithm, fillColor);
+        DrawingAlgorithm::FillPolygon(hdc, points, holes, algorithm, fillColor);
     }
 }
 
@@ -487,28 +538,21 @@ void FilledRegion::SetPreviewPoint(const Point& p) {}
 
 // ==================== Line 类变换实现 ====================
 
-void Line::Translate(int dx, int dy) {
-    start = start.Translate(dx, dy);
-    end = end.Translate(dx, dy);
-}
-
-void Line::Scale(double sx, double sy, const Point& center) {
-    start = start.Scale(sx, sy, center);
-    end = end.Scale(sx, sy, center);
-}
-
-void Line::Rotate(double angleRad, const Point& center) {
-    start = start.Rotate(angleRad, center);
-    end = end.Rotate(angleRad, center);
+// 两个端点一起送入批量变换
+void Line::RealizeGeometry() const {
+    Point device[2];
+    AffineTransform::Map(ends, device, 2, transform);
+    start = device[0];
+    end = device[1];
 }
 
 Point Line::GetCenter() const {
+    EnsureGeometry();
     return Point((start.x + end.x) / 2, (start.y + end.y) / 2);
 }
 
-bool Line::HitTest(const Point& p, int tolerance) const {
-    if (!complete) return false;
-    
+// 点 p 到线段 start-end 的距离是否不超过 tolerance（Line 与 Polyline 的命中测试共用）
+static bool IsNearSegment(const Point& p, const Point& start, const Point& end, int tolerance) {
     // 点到线段的距离判断
     int dx = end.x - start.x;
     int dy = end.y - start.y;
@@ -529,25 +573,40 @@ bool Line::HitTest(const Point& p, int tolerance) const {
     return p.DistanceTo(closest) <= tolerance;
 }
 
+bool Line::HitTest(const Point& p, int tolerance) const {
+    if (!complete) return false;
+    EnsureGeometry();
+    return IsNearSegment(p, start, end, tolerance);
+}
+
 // ==================== Circle 类变换实现 ====================
 
-void Circle::Translate(int dx, int dy) {
-    center = center.Translate(dx, dy);
+// 圆心随矩阵变换（旋转只移动圆心），半径只受缩放影响
+void Circle::RealizeGeometry() const {
+    AffineTransform::Map(&origin, &center, 1, transform);
+    radius = radiusScale == 1.0 ? baseRadius : (int)lrint(baseRadius * radiusScale);
+    outlineValid = false;
 }
 
-void Circle::Scale(double sx, double sy, const Point& scaleCenter) {
-    center = center.Scale(sx, sy, scaleCenter);
-    // 使用平均缩放因子缩放半径
-    radius = (int)(radius * (sx + sy) / 2.0);
+const std::vector<Point>* Circle::GetOutline() const {
+    if (!complete) return nullptr;
+    EnsureGeometry();
+    if (!outlineValid) {
+        DrawingAlgorithm::GetCircleOutline(center.x, center.y, radius, OUTLINE_TOLERANCE, outline);
+        outlineValid = true;
+    }
+    return outline.size() >= 3 ? &outline : nullptr;
 }
 
-void Circle::Rotate(double angleRad, const Point& rotateCenter) {
-    // 旋转圆心，半径不变
-    center = center.Rotate(angleRad, rotateCenter);
+void Circle::Scale(double sx, double sy, const Point& scaleCenter) {
+    // 使用平均缩放因子缩放半径
+    radiusScale *= (sx + sy) / 2.0;
+    Shape::Scale(sx, sy, scaleCenter);
 }
 
 bool Circle::HitTest(const Point& p, int tolerance) const {
     if (!complete) return false;
+    EnsureGeometry();
     
     // 点击圆周附近或圆内部
     double distance = p.DistanceTo(center);
@@ -557,28 +616,34 @@ bool Circle::HitTest(const Point& p, int tolerance) const {
 
 // ==================== Rectangle 类变换实现 ====================
 
-void Rectangle::Translate(int dx, int dy) {
-    topLeft = topLeft.Translate(dx, dy);
-    bottomRight = bottomRight.Translate(dx, dy);
-}
-
-void Rectangle::Scale(double sx, double sy, const Point& center) {
-    topLeft = topLeft.Scale(sx, sy, center);
-    bottomRight = bottomRight.Scale(sx, sy, center);
-}
-
-void Rectangle::Rotate(double angleRad, const Point& center) {
-    topLeft = topLeft.Rotate(angleRad, center);
-    bottomRight = bottomRight.Rotate(angleRad, center);
+void Rectangle::RealizeGeometry() const {
+    Point device[2];
+    AffineTransform::Map(corners, device, 2, transform);
+    topLeft = device[0];
+    bottomRight = device[1];
+    outlineValid = false;
+}
+
+// 矩形的四个顶点(按顺时针或逆时针顺序)
+const std::vector<Point>* Rectangle::GetOutline() const {
+    if (!complete) return nullptr;
+    EnsureGeometry();
+    if (!outlineValid) {
+        outline = { topLeft, Point(bottomRight.x, topLeft.y), bottomRight, Point(topLeft.x, bottomRight.y) };
+        outlineValid = true;
+    }
+    return &outline;
 }
 
 Point Rectangle::GetCenter() const {
+    EnsureGeometry();
     return Point((topLeft.x + bottomRight.x) / 2, 
                  (topLeft.y + bottomRight.y) / 2);
 }
 
 bool Rectangle::HitTest(const Point& p, int tolerance) const {
     if (!complete) return false;
+    EnsureGeometry();
     
     int left = std::min(topLeft.x, bottomRight.x);
     int right = std::max(topLeft.x, bottomRight.x);
@@ -599,25 +664,18 @@ bool Rectangle::HitTest(const Point& p, int tolerance) const {
 
 // ==================== Polyline 类变换实现 ====================
 
-void Polyline::Translate(int dx, int dy) {
-    for (auto& p : points) {
-        p = p.Translate(dx, dy);
-    }
+void Polyline::RealizeGeometry() const {
+    AffineTransform::Map(basePoints, points, transform);
 }
 
-void Polyline::Scale(double sx, double sy, const Point& center) {
-    for (auto& p : points) {
-        p = p.Scale(sx, sy, center);
-    }
-}
-
-void Polyline::Rotate(double angleRad, const Point& center) {
-    for (auto& p : points) {
-        p = p.Rotate(angleRad, center);
-    }
+const std::vector<Point>* Polyline::GetOutline() const {
+    if (!closed || basePoints.size() < 3) return nullptr;
+    EnsureGeometry();
+    return &points;
 }
 
 Point Polyline::GetCenter() const {
+    EnsureGeometry();
     if (points.empty()) return Point();
     
     int sumX = 0, sumY = 0;
@@ -629,22 +687,19 @@ Point Polyline::GetCenter() const {
 }
 
 bool Polyline::HitTest(const Point& p, int tolerance) const {
+    EnsureGeometry();
     if (points.size() < 2) return false;
     
     // 检查是否靠近任何线段
     for (size_t i = 0; i < points.size() - 1; i++) {
-        Line tempLine;
-        tempLine.SetEndpoints(points[i], points[i + 1]);
-        if (tempLine.HitTest(p, tolerance)) {
+        if (IsNearSegment(p, points[i], points[i + 1], tolerance)) {
             return true;
         }
     }
     
     // 如果是闭合的，检查最后一条边
     if (closed && points.size() >= 2) {
-        Line tempLine;
-        tempLine.SetEndpoints(points.back(), points.front());
-        if (tempLine.HitTest(p, tolerance)) {
+        if (IsNearSegment(p, points.back(), points.front(), tolerance)) {
             return true;
         }
     }
@@ -670,36 +725,34 @@ bool Polyline::HitTest(const Point& p, int tolerance) const {
 Polygon::Polygon() : complete(false), previewPoint(0, 0) {}
 
 void Polygon::Draw(HDC hdc) {
+    EnsureGeometry();
     if (vertices.size() < 2) return;
     
-    // 绘制多边形边
-    HPEN hPen = CreatePen(PS_SOLID, 2, isSelected ? RGB(255, 0, 0) : RGB(0, 0, 0));
-    HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
-    
-    MoveToEx(hdc, vertices[0].x, vertices[0].y, NULL);
-    for (size_t i = 1; i < vertices.size(); i++) {
-        LineTo(hdc, vertices[i].x, vertices[i].y);
-    }
-    
-    // 如果已完成，闭合多边形
-    if (complete && vertices.size() >= 3) {
-        LineTo(hdc, vertices[0].x, vertices[0].y);
+    // 绘制多边形边（如果已完成，闭合多边形）
+    DrawingAlgorithm::DrawPolyline(hdc, vertices, complete && vertices.size() >= 3, LineAlgorithm::GDI,
+                                   isSelected ? RGB(255, 0, 0) : RGB(0, 0, 0), 2);
+    for (const auto& hole : holes) {
+        DrawingAlgorithm::DrawPolyline(hdc, hole, true, LineAlgorithm::GDI,
+                                       isSelected ? RGB(255, 0, 0) : RGB(0, 0, 0), 2);
     }
     
-    SelectObject(hdc, hOldPen);
-    DeleteObject(hPen);
-    
     // 绘制顶点标记
     HBRUSH hBrush = CreateSolidBrush(RGB(0, 255, 0));
     HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hBrush);
     for (const auto& v : vertices) {
         Ellipse(hdc, v.x - 3, v.y - 3, v.x + 3, v.y + 3);
     }
+    for (const auto& hole : holes) {
+        for (const auto& v : hole) {
+            Ellipse(hdc, v.x - 3, v.y - 3, v.x + 3, v.y + 3);
+        }
+    }
     SelectObject(hdc, hOldBrush);
     DeleteObject(hBrush);
 }
 
 void Polygon::DrawPreview(HDC hdc) {
+    EnsureGeometry();
     if (vertices.empty() || complete) return;
     
     // 绘制从最后一个顶点到鼠标位置的预览线
@@ -723,41 +776,35 @@ bool Polygon::IsComplete() const {
 }
 
 void Polygon::AddPoint(const Point& p) {
+    InvalidateGeometry();
     if (complete) return;
-    vertices.push_back(p);
+    baseVertices.push_back(p);
 }
 
 void Polygon::SetPreviewPoint(const Point& p) {
+    InvalidateBounds();
     if (!complete) {
         previewPoint = p;
     }
 }
 
 void Polygon::Close() {
-    if (vertices.size() >= 3) {
+    InvalidateBounds();
+    if (baseVertices.size() >= 3) {
         complete = true;
     }
 }
 
-void Polygon::Translate(int dx, int dy) {
-    for (auto& v : vertices) {
-        v = v.Translate(dx, dy);
-    }
-}
-
-void Polygon::Scale(double sx, double sy, const Point& center) {
-    for (auto& v : vertices) {
-        v = v.Scale(sx, sy, center);
-    }
-}
-
-void Polygon::Rotate(double angleRad, const Point& center) {
-    for (auto& v : vertices) {
-        v = v.Rotate(angleRad, center);
+void Polygon::RealizeGeometry() const {
+    AffineTransform::Map(baseVertices, vertices, transform);
+    holes.resize(baseHoles.size());
+    for (size_t i = 0; i < baseHoles.size(); i++) {
+        AffineTransform::Map(baseHoles[i], holes[i], transform);
     }
 }
 
 Point Polygon::GetCenter() const {
+    EnsureGeometry();
     if (vertices.empty()) return Point();
     
     int sumX = 0, sumY = 0;
@@ -769,23 +816,16 @@ Point Polygon::GetCenter() const {
 }
 
 bool Polygon::HitTest(const Point& p, int tolerance) const {
+    EnsureGeometry();
     if (vertices.size() < 2) return false;
     
-    // 首先检查是否靠近任何边
-    for (size_t i = 0; i < vertices.size(); i++) {
-        size_t next = (i + 1) % vertices.size();
-        if (!complete && next == 0) break;  // 未闭合时不检查最后一条边
-        
-        // 检查点到线段的距离
-        const Point& p1 = vertices[i];
-        const Point& p2 = vertices[next];
-        
-        // 计算点到线段的距离
+    // 检查点到线段的距离
+    auto nearEdge = [&](const Point& p1, const Point& p2) {
         int dx = p2.x - p1.x;
         int dy = p2.y - p1.y;
         double lineLengthSquared = dx * dx + dy * dy;
         
-        if (lineLengthSquared < 1) continue; // 线段太短，跳过
+        if (lineLengthSquared < 1) return false; // 线段太短，跳过
         
         double t = ((p.x - p1.x) * dx + (p.y - p1.y) * dy) / (double)lineLengthSquared;
         t = std::max(0.0, std::min(1.0, t));
@@ -797,19 +837,32 @@ bool Polygon::HitTest(const Point& p, int tolerance) const {
         int distY = p.y - closestY;
         double distance = sqrt(distX * distX + distY * distY);
         
-        if (distance <= tolerance) {
-            return true;
+        return distance <= tolerance;
+    };
+    
+    // 首先检查是否靠近任何边
+    for (size_t i = 0; i < vertices.size(); i++) {
+        size_t next = (i + 1) % vertices.size();
+        if (!complete && next == 0) break;  // 未闭合时不检查最后一条边
+        if (nearEdge(vertices[i], vertices[next])) return true;
+    }
+    for (const auto& hole : holes) {
+        for (size_t i = 0; i < hole.size(); i++) {
+            if (nearEdge(hole[i], hole[(i + 1) % hole.size()])) return true;
         }
     }
     
-    // 如果多边形已闭合，也检查是否在内部
+    // 如果多边形已闭合，也检查是否在内部（与填充相同的奇偶规则，洞内不算）
     if (complete && vertices.size() >= 3) {
         bool inside = false;
-        for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
-            if (((vertices[i].y > p.y) != (vertices[j].y > p.y)) &&
-                (p.x < (vertices[j].x - vertices[i].x) * (p.y - vertices[i].y) / 
-                       (vertices[j].y - vertices[i].y) + vertices[i].x)) {
-                inside = !inside;
+        for (size_t ring = 0; ring <= holes.size(); ring++) {
+            const std::vector<Point>& pts = ring == 0 ? vertices : holes[ring - 1];
+            for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++) {
+                if (((pts[i].y > p.y) != (pts[j].y > p.y)) &&
+                    (p.x < (pts[j].x - pts[i].x) * (p.y - pts[i].y) / 
+                           (pts[j].y - pts[i].y) + pts[i].x)) {
+                    inside = !inside;
+                }
             }
         }
         if (inside) return true;
@@ -820,34 +873,20 @@ bool Polygon::HitTest(const Point& p, int tolerance) const {
 
 // ==================== BSpline 类变换实现 ====================
 
-void BSpline::Translate(int dx, int dy) {
-    for (auto& p : controlPoints) {
-        p = p.Translate(dx, dy);
-    }
-    for (auto& p : curvePoints) {
-        p = p.Translate(dx, dy);
-    }
+// 变换后控制点整体改变，细分的曲线作废，下次用到时重新生成
+void BSpline::RealizeGeometry() const {
+    AffineTransform::Map(baseControlPoints, controlPoints, transform);
+    InvalidateCurve();
 }
 
-void BSpline::Scale(double sx, double sy, const Point& center) {
-    for (auto& p : controlPoints) {
-        p = p.Scale(sx, sy, center);
-    }
-    for (auto& p : curvePoints) {
-        p = p.Scale(sx, sy, center);
-    }
-}
-
-void BSpline::Rotate(double angleRad, const Point& center) {
-    for (auto& p : controlPoints) {
-        p = p.Rotate(angleRad, center);
-    }
-    for (auto& p : curvePoints) {
-        p = p.Rotate(angleRad, center);
-    }
+const std::vector<Point>* BSpline::GetOutline() const {
+    if (!complete) return nullptr;
+    UpdateCurve();
+    return curve.size() >= 3 ? &curve : nullptr;
 }
 
 Point BSpline::GetCenter() const {
+    EnsureGeometry();
     if (controlPoints.empty()) return Point();
     
     int sumX = 0, sumY = 0;
@@ -859,8 +898,9 @@ Point BSpline::GetCenter() const {
 }
 
 bool BSpline::HitTest(const Point& p, int tolerance) const {
+    EnsureGeometry();
     // 如果还没有足够的控制点，只检查控制点
-    if (controlPoints.size() < 4) {
+    if (controlPoints.size() < (size_t)degree + 1) {
         for (const auto& cp : controlPoints) {
             if (p.DistanceTo(cp) <= tolerance + 5) { // 增大容差
                 return true;
@@ -876,15 +916,16 @@ bool BSpline::HitTest(const Point& p, int tolerance) const {
         }
     }
     
-    // 检查是否靠近曲线上的点
-    for (const auto& curvePt : curvePoints) {
-        if (p.DistanceTo(curvePt) <= tolerance + 2) {
+    // 检查是否靠近曲线上的标记点（每段曲线的终点）
+    UpdateCurve();
+    for (size_t k = 0; k < curveEnds.size(); k++) {
+        if (p.DistanceTo(SegmentEnd(k)) <= tolerance + 2) {
             return true;
         }
     }
     
     // 如果曲线点较少，检查是否靠近控制多边形
-    if (curvePoints.size() < controlPoints.size() * 5 && controlPoints.size() >= 2) {
+    if (curveEnds.size() < controlPoints.size() * 5 && controlPoints.size() >= 2) {
         for (size_t i = 0; i < controlPoints.size() - 1; i++) {
             const Point& p1 = controlPoints[i];
             const Point& p2 = controlPoints[i + 1];
@@ -913,3 +954,85 @@ bool BSpline::HitTest(const Point& p, int tolerance) const {
     
     return false;
 }
+
+// ==================== 包围盒与光栅化 ====================
+// 包围盒按 GDI 画笔宽度向外留出余量（宽度为 w 的画笔向两侧各扩展约 w/2 个像素）
+
+Rect Line::ComputeBounds() const {
+    EnsureGeometry();
+    if (!complete) return Rect(start, previewEnd).Inflate(1);
+    return Rect(start, end).Inflate(isSelected ? 2 : 0);
+}
+
+// 软件算法绘制且未选中（选中高亮使用 GDI 粗画笔）时可以直接光栅化
+bool Line::CanRasterize() const {
+    return algorithm != LineAlgorithm::GDI && !isSelected;
+}
+
+void Line::Rasterize(RasterTarget& target) const {
+    EnsureGeometry();
+    if (complete) {
+        DrawingAlgorithm::DrawLine(target, start.x, start.y, end.x, end.y, algorithm, GetColor());
+    }
+}
+
+Rect Circle::ComputeBounds() const {
+    EnsureGeometry();
+    if (!complete) {
+        int r = (int)center.DistanceTo(previewPoint);
+        return Rect(center.x - r, center.y - r, center.x + r, center.y + r).Inflate(1);
+    }
+    return Rect(center.x - radius, center.y - radius, center.x + radius, center.y + radius).Inflate(isSelected ? 2 : 0);
+}
+
+bool Circle::CanRasterize() const {
+    return algorithm != CircleAlgorithm::GDI && !isSelected;
+}
+
+void Circle::Rasterize(RasterTarget& target) const {
+    EnsureGeometry();
+    if (complete && radius > 0) {
+        DrawingAlgorithm::DrawCircle(target, center.x, center.y, radius, algorithm, GetColor());
+    }
+}
+
+Rect Rectangle::ComputeBounds() const {
+    EnsureGeometry();
+    if (!complete) return Rect(topLeft, previewPoint).Inflate(1);
+    return Rect(topLeft, bottomRight).Inflate(isSelected ? 2 : 1);
+}
+
+Rect Polyline::ComputeBounds() const {
+    EnsureGeometry();
+    return DrawingAlgorithm::GetPolygonBounds(points).Inflate(isSelected ? 2 : 1);
+}
+
+// 顶点标记是半径 3 的圆
+Rect Polygon::ComputeBounds() const {
+    EnsureGeometry();
+    Rect bounds = DrawingAlgorithm::GetPolygonBounds(vertices).Inflate(3);
+    if (!complete && !vertices.empty()) {
+        bounds = bounds.Union(Rect(previewPoint, previewPoint).Inflate(1));
+    }
+    return bounds;
+}
+
+// 曲线落在控制点的凸包内；控制点标记半径 3，曲线标记半径 4
+Rect BSpline::ComputeBounds() const {
+    EnsureGeometry();
+    Rect bounds = DrawingAlgorithm::GetPolygonBounds(controlPoints).Inflate(4);
+    if (hasPreview && !complete && !controlPoints.empty()) {
+        bounds = bounds.Union(Rect(previewPoint, previewPoint).Inflate(4));
+    }
+    return bounds;
+}
+
+Rect FilledRegion::ComputeBounds() const {
+    return DrawingAlgorithm::GetPolygonBounds(points);
+}
+
+void FilledRegion::Rasterize(RasterTarget& target) const {
+    if (points.size() >= 3) {
+        DrawingAlgorithm::FillPolygon(target, points, holes, algorithm, fillColor);
+    }
+}
@@ -1,14 +1,35 @@
 ﻿#pragma once
 #include <windows.h>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include "Point.h"
 #include "DrawingAlgorithm.h"
+#include "AffineTransform.h"
+#include "NurbsCurve.h"
+
+// 图形类型标记（ShapeStore 按类型分池存放，类型分派用 switch）
+enum class ShapeType : uint8_t {
+    Line,
+    Circle,
+    Rectangle,
+    Polyline,
+    Polygon,
+    BSpline,
+    FilledRegion
+};
 
 // 图形基类
 class Shape {
 public:
+    Shape() = default;
+    Shape(const Shape&) = default;
+    Shape& operator=(const Shape&) = default;
+    // 图形按值存放在 ShapeStore 的数组中，数组扩容时移动而不是复制顶点
+    Shape(Shape&&) = default;
+    Shape& operator=(Shape&&) = default;
     virtual ~Shape() {}
+    virtual ShapeType GetType() const = 0;
     virtual void Draw(HDC hdc) = 0;
     virtual bool IsComplete() const = 0;
     virtual void AddPoint(const Point& p) = 0;
@@ -16,35 +37,101 @@ public:
     virtual void DrawPreview(HDC hdc) = 0;
     
     // ==================== 实验二：几何变换接口 ====================
+    // 变换只累积到 transform 矩阵中（O(1)），顶点保持原始值，设备坐标在用到时才重新计算
     // 平移
-    virtual void Translate(int dx, int dy) = 0;
+    virtual void Translate(int dx, int dy) { ComposeTransform(AffineMatrix::Translation(dx, dy), Point()); }
     // 缩放（相对于中心点）
-    virtual void Scale(double sx, double sy, const Point& center) = 0;
+    virtual void Scale(double sx, double sy, const Point& center) { ComposeTransform(AffineMatrix::Scaling(sx, sy), center); }
     // 旋转（相对于中心点，角度为弧度）
-    virtual void Rotate(double angleRad, const Point& center) = 0;
+    virtual void Rotate(double angleRad, const Point& center) { ComposeTransform(AffineMatrix::Rotation(angleRad), center); }
     // 获取图形中心点（用于变换）
     virtual Point GetCenter() const = 0;
     // 命中测试（用于选择图形）
     virtual bool HitTest(const Point& p, int tolerance = 5) const = 0;
     // 设置选中状态
-    virtual void SetSelected(bool selected) { isSelected = selected; }
+    virtual void SetSelected(bool selected) { isSelected = selected; InvalidateBounds(); }
     virtual bool IsSelected() const { return isSelected; }
     
+    // ==================== 光栅化接口 ====================
+    // Draw 可能触及的像素范围（包含边界，含选中高亮和标记；未完成的图形还包括 DrawPreview 的预览）
+    // 结果会缓存，几何形状或选中状态变化时失效
+    Rect GetBounds() const {
+        if (!boundsValid) {
+            cachedBounds = ComputeBounds();
+            boundsValid = true;
+        }
+        return cachedBounds;
+    }
+    // 是否完全由软件光栅化算法绘制（不经过 GDI），这样的图形可以分块并行画到内存表面
+    virtual bool CanRasterize() const { return false; }
+    // 画到光栅目标上，结果与 Draw 相同；只在 CanRasterize 为 true 时调用
+    virtual void Rasterize(RasterTarget& target) const {}
+    
+    // ==================== 填充与裁剪接口 ====================
+    // 轮廓折线化的误差容限（像素）
+    static constexpr double OUTLINE_TOLERANCE = 0.5;
+    // 图形围成的区域的闭合轮廓（设备坐标，至少 3 个顶点），用于填充和多边形裁剪；
+    // 曲线按 OUTLINE_TOLERANCE 折线化并随图形缓存。未完成或不能围成区域时返回 nullptr，
+    // 返回的指针在图形修改后失效
+    virtual const std::vector<Point>* GetOutline() const { return nullptr; }
+    // 区域内的洞（设备坐标），与 GetOutline 一起按奇偶规则确定区域；没有洞时返回 nullptr
+    virtual const std::vector<std::vector<Point>>* GetHoles() const { return nullptr; }
+    
 protected:
     bool isSelected = false;
+    // 原始几何到设备坐标的累积变换（绝对坐标矩阵）
+    AffineMatrix transform = AffineMatrix::Identity();
+    
+    // 计算包围盒（不使用缓存）
+    virtual Rect ComputeBounds() const = 0;
+    // 修改顶点、预览点或选中状态后调用，使缓存的包围盒失效
+    void InvalidateBounds() { boundsValid = false; }
+    
+    // 把 transform 应用到原始几何，刷新设备坐标缓存；由 EnsureGeometry 在缓存失效时调用
+    virtual void RealizeGeometry() const {}
+    // 读取设备坐标前调用
+    void EnsureGeometry() const {
+        if (!geometryValid) {
+            RealizeGeometry();
+            geometryValid = true;
+        }
+    }
+    // 修改原始几何或 transform 后调用，使设备坐标缓存和包围盒失效
+    void InvalidateGeometry() { geometryValid = false; boundsValid = false; }
+    // 设备坐标缓存是否有效（子类可以据此增量更新缓存而不是整体失效）
+    bool IsGeometryValid() const { return geometryValid; }
+    // 直接以设备坐标重设几何时调用（裁剪结果等），之后原始几何即设备坐标
+    void ResetTransform() { transform = AffineMatrix::Identity(); InvalidateGeometry(); }
+    // 叠加一次相对 pivot 的变换
+    void ComposeTransform(const AffineMatrix& m, const Point& pivot) {
+        transform = AffineMatrix::Multiply(AffineMatrix::About(m, pivot), transform);
+        InvalidateGeometry();
+    }
+    
+private:
+    mutable Rect cachedBounds;
+    mutable bool boundsValid = false;
+    mutable bool geometryValid = false;
 };
 
 // 直线类
 class Line : public Shape {
 private:
-    Point start;
-    Point end;
+    Point ends[2];                // 原始端点（起点、终点）
+    mutable Point start;          // 设备坐标下的端点（缓存）
+    mutable Point end;
     bool hasStart;
     bool complete;
     LineAlgorithm algorithm;
     Point previewEnd;
     
+    COLORREF GetColor() const;
+    
+protected:
+    void RealizeGeometry() const override;
+    
 public:
+    ShapeType GetType() const override { return ShapeType::Line; }
     Line(LineAlgorithm algo = LineAlgorithm::GDI);
     void Draw(HDC hdc) override;
     void DrawPreview(HDC hdc) override;
@@ -52,33 +139,43 @@ public:
     void AddPoint(const Point& p) override;
     void SetPreviewPoint(const Point& p) override;
     void SetAlgorithm(LineAlgorithm algo);
+    Rect ComputeBounds() const override;
+    bool CanRasterize() const override;
+    void Rasterize(RasterTarget& target) const override;
     
     // 实验二：变换接口实现
-    void Translate(int dx, int dy) override;
-    void Scale(double sx, double sy, const Point& center) override;
-    void Rotate(double angleRad, const Point& center) override;
     Point GetCenter() const override;
     bool HitTest(const Point& p, int tolerance = 5) const override;
     
     // 获取端点（用于裁剪）
-    Point GetStart() const { return start; }
-    Point GetEnd() const { return end; }
-    void SetEndpoints(const Point& p1, const Point& p2) { start = p1; end = p2; }
+    Point GetStart() const { EnsureGeometry(); return start; }
+    Point GetEnd() const { EnsureGeometry(); return end; }
+    void SetEndpoints(const Point& p1, const Point& p2) { ends[0] = p1; ends[1] = p2; ResetTransform(); }
 };
 
 // 圆类
 class Circle : public Shape {
 private:
-    Point center;
-    int radius;
+    Point origin;                 // 原始圆心和半径
+    int baseRadius;
+    double radiusScale;           // 累积的半径缩放（各次缩放平均因子之积）
+    mutable Point center;         // 设备坐标下的圆心和半径（缓存）
+    mutable int radius;
+    mutable std::vector<Point> outline;   // 缓存的多边形轮廓（设备坐标变化后重新生成）
+    mutable bool outlineValid = false;
     bool hasCenter;
     bool complete;
     CircleAlgorithm algorithm;
     Point previewPoint;
     
     int CalculateRadius(const Point& p1, const Point& p2);
+    COLORREF GetColor() const;
+    
+protected:
+    void RealizeGeometry() const override;
     
 public:
+    ShapeType GetType() const override { return ShapeType::Circle; }
     Circle(CircleAlgorithm algo = CircleAlgorithm::GDI);
     void Draw(HDC hdc) override;
     void DrawPreview(HDC hdc) override;
@@ -86,54 +183,68 @@ public:
     void AddPoint(const Point& p) override;
     void SetPreviewPoint(const Point& p) override;
     void SetAlgorithm(CircleAlgorithm algo);
+    Rect ComputeBounds() const override;
+    bool CanRasterize() const override;
+    void Rasterize(RasterTarget& target) const override;
     
-    // 实验二：变换接口
-    void Translate(int dx, int dy) override;
+    // 实验二：变换接口（圆心随矩阵变换，半径按平均缩放因子缩放）
     void Scale(double sx, double sy, const Point& center) override;
-    void Rotate(double angleRad, const Point& center) override;
     Point GetCenter() const override;
     bool HitTest(const Point& p, int tolerance = 5) const override;
     
     // 获取圆的参数用于填充
     int GetRadius() const;
+    // 按 OUTLINE_TOLERANCE 决定顶点数的内接正多边形
+    const std::vector<Point>* GetOutline() const override;
 };
 
 // 矩形类
 class Rectangle : public Shape {
 private:
-    Point topLeft;
-    Point bottomRight;
+    Point corners[2];             // 原始的两个对角点
+    mutable Point topLeft;        // 设备坐标下的对角点（缓存）
+    mutable Point bottomRight;
+    mutable std::vector<Point> outline;   // 缓存的四个顶点
+    mutable bool outlineValid = false;
     bool hasFirstPoint;
     bool complete;
     Point previewPoint;
     
+protected:
+    void RealizeGeometry() const override;
+    
 public:
+    ShapeType GetType() const override { return ShapeType::Rectangle; }
     Rectangle();
     void Draw(HDC hdc) override;
     void DrawPreview(HDC hdc) override;
     bool IsComplete() const override;
     void AddPoint(const Point& p) override;
     void SetPreviewPoint(const Point& p) override;
+    Rect ComputeBounds() const override;
     
     // 实验二：变换接口
-    void Translate(int dx, int dy) override;
-    void Scale(double sx, double sy, const Point& center) override;
-    void Rotate(double angleRad, const Point& center) override;
     Point GetCenter() const override;
     bool HitTest(const Point& p, int tolerance = 5) const override;
     
     // 获取矩形的顶点用于填充
     Point GetTopLeft() const;
     Point GetBottomRight() const;
+    const std::vector<Point>* GetOutline() const override;
 };
 
 // 多段线类
 class Polyline : public Shape {
 private:
-    std::vector<Point> points;
+    std::vector<Point> basePoints;        // 原始顶点
+    mutable std::vector<Point> points;    // 设备坐标下的顶点（缓存）
     bool closed;
     
+protected:
+    void RealizeGeometry() const override;
+    
 public:
+    ShapeType GetType() const override { return ShapeType::Polyline; }
     Polyline();
     void Draw(HDC hdc) override;
     void DrawPreview(HDC hdc) override;
@@ -141,27 +252,34 @@ public:
     void AddPoint(const Point& p) override;
     void SetPreviewPoint(const Point& p) override;
     void Close();
+    Rect ComputeBounds() const override;
     
     // 实验二：变换接口
-    void Translate(int dx, int dy) override;
-    void Scale(double sx, double sy, const Point& center) override;
-    void Rotate(double angleRad, const Point& center) override;
     Point GetCenter() const override;
     bool HitTest(const Point& p, int tolerance = 5) const override;
     
     const std::vector<Point>& GetPoints() const;
     size_t GetPointCount() const;
+    // 闭合后顶点即轮廓
+    const std::vector<Point>* GetOutline() const override;
 };
 
 // ==================== 实验二：任意多边形类 ====================
 // 通过鼠标点击添加顶点，右键或双击结束并自动闭合
 class Polygon : public Shape {
 private:
-    std::vector<Point> vertices;   // 顶点
+    std::vector<Point> baseVertices;        // 原始顶点
+    mutable std::vector<Point> vertices;    // 设备坐标下的顶点（缓存）
+    std::vector<std::vector<Point>> baseHoles;          // 洞的原始顶点（布尔运算、裁剪的结果）
+    mutable std::vector<std::vector<Point>> holes;      // 设备坐标下的洞（缓存）
     bool complete;
     Point previewPoint;
     
+protected:
+    void RealizeGeometry() const override;
+    
 public:
+    ShapeType GetType() const override { return ShapeType::Polygon; }
     Polygon();
     void Draw(HDC hdc) override;
     void DrawPreview(HDC hdc) override;
@@ -169,66 +287,134 @@ public:
     void AddPoint(const Point& p) override;
     void SetPreviewPoint(const Point& p) override;
     void Close();  // 结束输入并闭合多边形
+    Rect ComputeBounds() const override;
     
     // 实验二：变换接口
-    void Translate(int dx, int dy) override;
-    void Scale(double sx, double sy, const Point& center) override;
-    void Rotate(double angleRad, const Point& center) override;
     Point GetCenter() const override;
     bool HitTest(const Point& p, int tolerance = 5) const override;
     
     // 获取顶点（用于裁剪）
-    const std::vector<Point>& GetVertices() const { return vertices; }
-    void SetVertices(const std::vector<Point>& verts) { vertices = verts; }
-    size_t GetVertexCount() const { return vertices.size(); }
+    const std::vector<Point>& GetVertices() const { EnsureGeometry(); return vertices; }
+    // 以设备坐标重设外环和洞（洞在外环内部，互不相交）
+    void SetVertices(const std::vector<Point>& verts, const std::vector<std::vector<Point>>& holeRings = {}) {
+        baseVertices = verts;
+        baseHoles = holeRings;
+        ResetTransform();
+    }
+    size_t GetVertexCount() const { return baseVertices.size(); }
+    const std::vector<Point>* GetOutline() const override {
+        return complete && baseVertices.size() >= 3 ? &GetVertices() : nullptr;
+    }
+    const std::vector<std::vector<Point>>* GetHoles() const override {
+        if (!complete || baseHoles.empty()) return nullptr;
+        EnsureGeometry();
+        return &holes;
+    }
 };
 
 // B样条曲线类
+// 默认是三次均匀 B 样条（前向差分细分）；也可以指定任意次数、节点向量和权重（NURBS，de Boor 求值）
 class BSpline : public Shape {
+public:
+    // 节点向量的类型
+    enum class KnotType {
+        Uniform,    // 均匀节点：曲线不经过端点控制点，增加控制点时已有的段不变
+        Clamped,    // 两端重复的均匀节点：曲线经过首尾控制点
+        Custom      // 由 SetKnots 指定
+    };
+    
 private:
-    std::vector<Point> controlPoints;     // 控制点
-    std::vector<Point> curvePoints;       // 曲线上的标记点
+    static constexpr double FLATNESS = OUTLINE_TOLERANCE;   // 细分的平直度容差（像素）
+    
+    int degree = 3;
+    KnotType knotType = KnotType::Uniform;
+    std::vector<double> knots;                    // 自定义节点（KnotType::Custom）
+    std::vector<double> weights;                  // 控制点权重，空表示全部为 1
+    std::vector<Point> baseControlPoints;         // 原始控制点
+    mutable std::vector<Point> controlPoints;     // 设备坐标下的控制点（缓存）
+    // 细分后的曲线（设备坐标）：第 k 段由控制点 k..k+degree 决定，点数随该段的弯曲程度和尺寸变化，
+    // 相邻两段共用连接点；curveEnds[k] 是第 k 段最后一个点在 curve 中的下标
+    // 变换后整体作废；增加控制点时只补算新出现的末尾曲线段
+    mutable std::vector<Point> curve;
+    mutable std::vector<size_t> curveEnds;
+    // 一般情形所用的 NURBS 曲线（设备坐标），与 curve 一起作废；均匀节点下增加控制点时原地追加
+    mutable NurbsCurve nurbs;
+    Point previewPoint;                           // 绘制过程中跟随鼠标的预览控制点
+    bool hasPreview = false;
     bool complete;
     int minPoints;
     
-    // 使用4个控制点和参数t计算曲线上的点(三次均匀B样条)
-    Point CalculateCurvePoint(const Point& p0, const Point& p1, const Point& p2, const Point& p3, double t);
+    // 默认的三次均匀 B 样条走专用的前向差分路径
+    bool IsUniformCubic() const { return degree == 3 && knotType == KnotType::Uniform && weights.empty(); }
+    // 按当前控制点、节点和权重建立 NURBS 曲线（参数不合法时为空）
+    void BuildNurbs(const std::vector<Point>& points, NurbsCurve& nurbs) const;
+    // 按平直度容差自适应细分以 cp[0..3] 为控制点的一段曲线，追加到 out
+    static void TessellateSegment(const Point* cp, std::vector<Point>& out);
+    // 补齐 curve 中缺少的末尾曲线段
+    void UpdateCurve() const;
+    // 丢弃细分的曲线，下次用到时整体重新生成
+    void InvalidateCurve() const { curve.clear(); curveEnds.clear(); nurbs.Clear(); }
+    // 第 k 段曲线的终点和中间的点（UpdateCurve 之后使用）
+    const Point& SegmentEnd(size_t k) const { return curve[curveEnds[k]]; }
+    const Point& SegmentMiddle(size_t k) const {
+        size_t first = k == 0 ? 0 : curveEnds[k - 1];
+        return curve[first + (curveEnds[k] - first) / 2];
+    }
+    
+protected:
+    void RealizeGeometry() const override;
     
 public:
+    ShapeType GetType() const override { return ShapeType::BSpline; }
     BSpline(int minPts = 4);
+    // 任意次数的曲线（至少需要 degree + 1 个控制点）
+    BSpline(int degree, KnotType knotType);
     void Draw(HDC hdc) override;
     void DrawPreview(HDC hdc) override;
     bool IsComplete() const override;
     void AddPoint(const Point& p) override;
     void SetPreviewPoint(const Point& p) override;
     void Finish();
+    Rect ComputeBounds() const override;
     
     // 实验二：变换接口
-    void Translate(int dx, int dy) override;
-    void Scale(double sx, double sy, const Point& center) override;
-    void Rotate(double angleRad, const Point& center) override;
     Point GetCenter() const override;
     bool HitTest(const Point& p, int tolerance = 5) const override;
     
     size_t GetPointCount() const;
-    const std::vector<Point>& GetPoints() const { return controlPoints; }
+    const std::vector<Point>& GetPoints() const { EnsureGeometry(); return controlPoints; }
+    int GetDegree() const { return degree; }
+    // 设置控制点权重（个数与控制点相同，均为正数；空表示全部为 1）；之后添加的控制点权重为 1
+    void SetWeights(const std::vector<double>& w);
+    // 设置自定义节点向量（个数为控制点数 + degree + 1，非递减），节点类型变为 Custom
+    void SetKnots(const std::vector<double>& k);
+    // 细分后的曲线折线（设备坐标，用于裁剪等）
+    const std::vector<Point>& GetCurve() const { UpdateCurve(); return curve; }
+    // 完成的曲线首尾相连作为轮廓
+    const std::vector<Point>* GetOutline() const override;
 };
 
 // 填充区域类(用于封闭图形的填充)
 class FilledRegion : public Shape {
 private:
     std::vector<Point> points;
+    std::vector<std::vector<Point>> holes;  // 不填充的洞
     FillAlgorithm algorithm;
     bool complete;
     COLORREF fillColor;
     
 public:
-    FilledRegion(const std::vector<Point>& pts, FillAlgorithm algo, COLORREF color = RGB(100, 100, 255));
+    ShapeType GetType() const override { return ShapeType::FilledRegion; }
+    FilledRegion(const std::vector<Point>& pts, FillAlgorithm algo, COLORREF color = RGB(100, 100, 255),
+                 const std::vector<std::vector<Point>>& holeRings = {});
     void Draw(HDC hdc) override;
     void DrawPreview(HDC hdc) override;
     bool IsComplete() const override;
     void AddPoint(const Point& p) override;
     void SetPreviewPoint(const Point& p) override;
+    Rect ComputeBounds() const override;
+    bool CanRasterize() const override { return true; }
+    void Rasterize(RasterTarget& target) const override;
     
     // 实验二：变换接口（填充区域不需要变换）
     void Translate(int dx, int dy) override {}
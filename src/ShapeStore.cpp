@@ -0,0 +1,128 @@
+#include "ShapeStore.h"
+
+ShapeHandle ShapeStore::HandleAt(size_t i) const {
+    return slots.HandleOf(order[i]);
+}
+
+int ShapeStore::IndexOf(ShapeHandle handle) const {
+    if (!slots.IsValid(handle)) return -1;
+    for (size_t i = 0; i < order.size(); i++) {
+        if (order[i] == handle.slot) return (int)i;
+    }
+    return -1;
+}
+
+Shape* ShapeStore::Get(ShapeHandle handle) {
+    if (!slots.IsValid(handle)) return nullptr;
+    return &Resolve(handle.slot);
+}
+
+Shape& ShapeStore::Resolve(uint32_t slot) {
+    const auto& s = slots[slot];
+    switch (s.type) {
+    case ShapeType::Line:         return lines.items[s.index];
+    case ShapeType::Circle:       return circles.items[s.index];
+    case ShapeType::Rectangle:    return rectangles.items[s.index];
+    case ShapeType::Polyline:     return polylines.items[s.index];
+    case ShapeType::Polygon:      return polygons.items[s.index];
+    case ShapeType::BSpline:      return bsplines.items[s.index];
+    default:                      return filledRegions.items[s.index];
+    }
+}
+
+const Shape& ShapeStore::Resolve(uint32_t slot) const {
+    return const_cast<ShapeStore*>(this)->Resolve(slot);
+}
+
+void ShapeStore::Store(uint32_t slot, std::unique_ptr<Shape> shape) {
+    auto& s = slots[slot];
+    s.type = shape->GetType();
+    switch (s.type) {
+    case ShapeType::Line:
+        s.index = lines.Push(std::move(static_cast<Line&>(*shape)), slot);
+        break;
+    case ShapeType::Circle:
+        s.index = circles.Push(std::move(static_cast<Circle&>(*shape)), slot);
+        break;
+    case ShapeType::Rectangle:
+        s.index = rectangles.Push(std::move(static_cast<class Rectangle&>(*shape)), slot);
+        break;
+    case ShapeType::Polyline:
+        s.index = polylines.Push(std::move(static_cast<class Polyline&>(*shape)), slot);
+        break;
+    case ShapeType::Polygon:
+        s.index = polygons.Push(std::move(static_cast<class Polygon&>(*shape)), slot);
+        break;
+    case ShapeType::BSpline:
+        s.index = bsplines.Push(std::move(static_cast<BSpline&>(*shape)), slot);
+        break;
+    case ShapeType::FilledRegion:
+        s.index = filledRegions.Push(std::move(static_cast<FilledRegion&>(*shape)), slot);
+        break;
+    }
+}
+
+void ShapeStore::Release(uint32_t slot) {
+    auto& s = slots[slot];
+    uint32_t moved = ShapeHandle::INVALID_SLOT;
+    switch (s.type) {
+    case ShapeType::Line:         moved = lines.RemoveAt(s.index); break;
+    case ShapeType::Circle:       moved = circles.RemoveAt(s.index); break;
+    case ShapeType::Rectangle:    moved = rectangles.RemoveAt(s.index); break;
+    case ShapeType::Polyline:     moved = polylines.RemoveAt(s.index); break;
+    case ShapeType::Polygon:      moved = polygons.RemoveAt(s.index); break;
+    case ShapeType::BSpline:      moved = bsplines.RemoveAt(s.index); break;
+    case ShapeType::FilledRegion: moved = filledRegions.RemoveAt(s.index); break;
+    }
+    // 池尾元素填补到了被删除的位置
+    if (moved != ShapeHandle::INVALID_SLOT) {
+        slots[moved].index = s.index;
+    }
+
+    slots.Release(slot);
+}
+
+ShapeHandle ShapeStore::Add(std::unique_ptr<Shape> shape) {
+    uint32_t slot = slots.Allocate();
+    Store(slot, std::move(shape));
+    order.push_back(slot);
+    return HandleAt(order.size() - 1);
+}
+
+ShapeHandle ShapeStore::Replace(size_t i, std::unique_ptr<Shape> shape) {
+    Release(order[i]);
+    uint32_t slot = slots.Allocate();
+    Store(slot, std::move(shape));
+    order[i] = slot;
+    return HandleAt(i);
+}
+
+void ShapeStore::Erase(const std::vector<size_t>& positions) {
+    if (positions.empty()) return;
+
+    // 一次遍历压缩顺序表
+    size_t next = 0;
+    size_t write = 0;
+    for (size_t read = 0; read < order.size(); read++) {
+        if (next < positions.size() && positions[next] == read) {
+            Release(order[read]);
+            next++;
+        } else {
+            order[write++] = order[read];
+        }
+    }
+    order.resize(write);
+}
+
+void ShapeStore::Clear() {
+    // 保留槽位只递增代数，清空前取得的句柄不会解析到之后加入的图形
+    slots.ReleaseAll();
+    order.clear();
+    lines.Clear();
+    circles.Clear();
+    rectangles.Clear();
+    polylines.Clear();
+    polygons.Clear();
+    bsplines.Clear();
+    filledRegions.Clear();
+}
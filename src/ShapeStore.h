@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Shape.h"
+#include "SlotTable.h"
+
+// 图形仓库
+// 每种图形按值存放在各自的连续数组中（按类型分池），另有绘制顺序表记录图形从下到上的先后。
+// 删除时用池尾元素填补空位，池始终紧凑；按类型处理（如裁剪所有直线）时直接遍历对应的池，
+// 按绘制顺序处理时经槽位表找到池中的元素，类型分派是一个 switch，不涉及引用计数。
+// 增删图形可能使池中元素移动，之前取得的 Shape 引用随之失效，需要长期引用时使用句柄。
+class ShapeStore {
+public:
+    size_t Size() const { return order.size(); }
+    bool Empty() const { return order.empty(); }
+
+    // 绘制顺序中的第 i 个图形（0 为最下层）
+    Shape& operator[](size_t i) { return Resolve(order[i]); }
+    const Shape& operator[](size_t i) const { return Resolve(order[i]); }
+    ShapeType TypeAt(size_t i) const { return slots[order[i]].type; }
+    ShapeHandle HandleAt(size_t i) const;
+    // 句柄对应图形在绘制顺序中的位置（线性查找），句柄失效时返回 -1
+    int IndexOf(ShapeHandle handle) const;
+
+    // 按句柄访问，句柄失效时返回 nullptr
+    Shape* Get(ShapeHandle handle);
+
+    // 追加到最上层
+    ShapeHandle Add(std::unique_ptr<Shape> shape);
+    // 用另一个图形替换第 i 个（位置不变，原句柄失效）
+    ShapeHandle Replace(size_t i, std::unique_ptr<Shape> shape);
+    // 删除绘制顺序中的若干位置（升序排列），其余图形保持相对顺序
+    void Erase(const std::vector<size_t>& positions);
+    void Clear();
+
+    // 某一类型的全部图形（连续存放，池内顺序与绘制顺序无关）
+    std::vector<Line>& Lines() { return lines.items; }
+
+private:
+    Shape& Resolve(uint32_t slot);
+    const Shape& Resolve(uint32_t slot) const;
+    // 把图形移入对应类型的池并登记到槽位
+    void Store(uint32_t slot, std::unique_ptr<Shape> shape);
+    // 从池中移除槽位对应的图形并释放槽位
+    void Release(uint32_t slot);
+
+    SlotTable<ShapeType> slots;
+    std::vector<uint32_t> order;       // 绘制顺序（槽位编号）
+
+    ShapePool<Line> lines;
+    ShapePool<Circle> circles;
+    ShapePool<class Rectangle> rectangles;
+    ShapePool<class Polyline> polylines;
+    ShapePool<class Polygon> polygons;
+    ShapePool<BSpline> bsplines;
+    ShapePool<FilledRegion> filledRegions;
+};
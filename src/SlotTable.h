@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 图形句柄：槽位编号 + 代数。图形删除、被替换或画布清空后槽位代数加一，旧句柄随之失效
+struct ShapeHandle {
+    static const uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+    uint32_t slot = INVALID_SLOT;
+    uint32_t generation = 0;
+
+    bool IsNull() const { return slot == INVALID_SLOT; }
+};
+
+// 同一类型图形的连续数组，owners[i] 为第 i 个元素所属的槽位
+template <class T>
+struct ShapePool {
+    std::vector<T> items;
+    std::vector<uint32_t> owners;
+
+    uint32_t Push(T&& item, uint32_t owner) {
+        items.push_back(std::move(item));
+        owners.push_back(owner);
+        return (uint32_t)items.size() - 1;
+    }
+
+    // 删除第 index 个元素，用末尾元素填补空位；返回被移动元素的槽位（没有移动时为 INVALID_SLOT）
+    uint32_t RemoveAt(uint32_t index) {
+        uint32_t last = (uint32_t)items.size() - 1;
+        uint32_t moved = ShapeHandle::INVALID_SLOT;
+        if (index != last) {
+            items[index] = std::move(items[last]);
+            owners[index] = owners[last];
+            moved = owners[index];
+        }
+        items.pop_back();
+        owners.pop_back();
+        return moved;
+    }
+
+    void Clear() {
+        items.clear();
+        owners.clear();
+    }
+};
+
+// 槽位表：每个槽位记录对象的类型、在该类型池中的下标和代数。
+// 槽位释放后代数加一并放入空闲表，再次分配时沿用新的代数；槽位本身从不删除（清空时也只是全部释放），
+// 所以释放前取得的句柄不会解析到之后放入同一槽位的对象
+template <class Type>
+class SlotTable {
+public:
+    struct Slot {
+        Type type;
+        uint32_t index;        // 在对应类型池中的下标
+        uint32_t generation;
+        bool alive;
+    };
+
+    Slot& operator[](uint32_t slot) { return slots[slot]; }
+    const Slot& operator[](uint32_t slot) const { return slots[slot]; }
+
+    ShapeHandle HandleOf(uint32_t slot) const {
+        ShapeHandle handle;
+        handle.slot = slot;
+        handle.generation = slots[slot].generation;
+        return handle;
+    }
+
+    bool IsValid(ShapeHandle handle) const {
+        if (handle.IsNull() || handle.slot >= slots.size()) return false;
+        const Slot& s = slots[handle.slot];
+        return s.alive && s.generation == handle.generation;
+    }
+
+    uint32_t Allocate() {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = (uint32_t)slots.size();
+            slots.push_back(Slot{ Type(), 0, 0, false });
+        }
+        slots[slot].alive = true;
+        return slot;
+    }
+
+    void Release(uint32_t slot) {
+        Slot& s = slots[slot];
+        s.alive = false;
+        s.generation++;
+        freeSlots.push_back(slot);
+    }
+
+    // 释放所有存活的槽位
+    void ReleaseAll() {
+        for (uint32_t i = 0; i < (uint32_t)slots.size(); i++) {
+            if (slots[i].alive) Release(i);
+        }
+    }
+
+private:
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+};
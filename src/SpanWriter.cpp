@@ -0,0 +1,228 @@
+#include "SpanWriter.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SPAN_WRITER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要为使用 SSE2/AVX2 指令的函数单独打开目标特性，
+// 这样整个程序不必以 -mavx2 编译，也能在不支持 AVX2 的机器上运行
+#if defined(__GNUC__)
+#define SPAN_TARGET(x) __attribute__((target(x)))
+#else
+#define SPAN_TARGET(x)
+#endif
+
+// ============ 标量实现 ============
+
+static void FillScalar(uint32_t* dst, int count, uint32_t color) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+// 单通道混合：(s * a + d * (255 - a)) / 255，四舍五入
+// srcTerm = s * a + 128 对整段相同，由调用方预先算好
+static inline uint32_t BlendChannel(uint32_t srcTerm, uint32_t d, uint32_t inv) {
+    uint32_t v = srcTerm + d * inv;
+    return (v + (v >> 8)) >> 8;
+}
+
+static void BlendScalar(uint32_t* dst, int count, uint32_t color, uint8_t alpha) {
+    uint32_t inv = 255 - alpha;
+    uint32_t r = ((color >> 16) & 0xFF) * alpha + 128;
+    uint32_t g = ((color >> 8) & 0xFF) * alpha + 128;
+    uint32_t b = (color & 0xFF) * alpha + 128;
+    uint32_t x = (color >> 24) * alpha + 128;
+    for (int i = 0; i < count; i++) {
+        uint32_t d = dst[i];
+        dst[i] = (BlendChannel(x, d >> 24, inv) << 24) |
+                 (BlendChannel(r, (d >> 16) & 0xFF, inv) << 16) |
+                 (BlendChannel(g, (d >> 8) & 0xFF, inv) << 8) |
+                 BlendChannel(b, d & 0xFF, inv);
+    }
+}
+
+#ifdef SPAN_WRITER_X86
+// ============ SSE2 实现 ============
+
+SPAN_TARGET("sse2")
+static void FillSSE2(uint32_t* dst, int count, uint32_t color) {
+    __m128i c = _mm_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm_storeu_si128((__m128i*)(dst + i), c);
+        _mm_storeu_si128((__m128i*)(dst + i + 4), c);
+        _mm_storeu_si128((__m128i*)(dst + i + 8), c);
+        _mm_storeu_si128((__m128i*)(dst + i + 12), c);
+    }
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(dst + i), c);
+    }
+    for (; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+SPAN_TARGET("sse2")
+static void BlendSSE2(uint32_t* dst, int count, uint32_t color, uint8_t alpha) {
+    const __m128i zero = _mm_setzero_si128();
+    // 源颜色的贡献 s * a + 128 对所有像素相同，预先算好
+    __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+    __m128i srcTerm = _mm_add_epi16(_mm_mullo_epi16(src, _mm_set1_epi16(alpha)), _mm_set1_epi16(128));
+    __m128i inv = _mm_set1_epi16((short)(255 - alpha));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv), srcTerm);
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv), srcTerm);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    BlendScalar(dst + i, count - i, color, alpha);
+}
+
+// ============ AVX2 实现 ============
+
+SPAN_TARGET("avx2")
+static void FillAVX2(uint32_t* dst, int count, uint32_t color) {
+    __m256i c = _mm256_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        _mm256_storeu_si256((__m256i*)(dst + i), c);
+        _mm256_storeu_si256((__m256i*)(dst + i + 8), c);
+        _mm256_storeu_si256((__m256i*)(dst + i + 16), c);
+        _mm256_storeu_si256((__m256i*)(dst + i + 24), c);
+    }
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i*)(dst + i), c);
+    }
+    if (i + 4 <= count) {
+        _mm_storeu_si128((__m128i*)(dst + i), _mm256_castsi256_si128(c));
+        i += 4;
+    }
+    for (; i < count; i++) {
+        dst[i] = color;
+    }
+}
+
+SPAN_TARGET("avx2")
+static void BlendAVX2(uint32_t* dst, int count, uint32_t color, uint8_t alpha) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i src = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)color), zero);
+    __m256i srcTerm = _mm256_add_epi16(_mm256_mullo_epi16(src, _mm256_set1_epi16(alpha)), _mm256_set1_epi16(128));
+    __m256i inv = _mm256_set1_epi16((short)(255 - alpha));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv), srcTerm);
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv), srcTerm);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    // 尾部交给非 VEX 编码的 SSE2 实现，先清掉 YMM 高半部分，避免 AVX/SSE 状态切换的惩罚
+    _mm256_zeroupper();
+    BlendSSE2(dst + i, count - i, color, alpha);
+}
+
+// ============ CPU 特性检测 ============
+
+static bool CpuHasSSE2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true;    // x86-64 必定支持 SSE2
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool CpuHasAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    // 操作系统必须保存 YMM 寄存器状态
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// ============ 运行时选择 ============
+
+// 先静态初始化为标量实现，保证任何全局对象构造期间调用也是安全的
+SpanWriter::FillFunc SpanWriter::fillFunc = FillScalar;
+SpanWriter::BlendFunc SpanWriter::blendFunc = BlendScalar;
+SpanKernel SpanWriter::kernel = SpanKernel::Scalar;
+
+bool SpanWriter::IsSupported(SpanKernel k) {
+    switch (k) {
+    case SpanKernel::Scalar:
+        return true;
+#ifdef SPAN_WRITER_X86
+    case SpanKernel::SSE2:
+        return CpuHasSSE2();
+    case SpanKernel::AVX2:
+        return CpuHasAVX2();
+#endif
+    default:
+        return false;
+    }
+}
+
+bool SpanWriter::SetKernel(SpanKernel k) {
+    if (!IsSupported(k)) return false;
+
+    switch (k) {
+#ifdef SPAN_WRITER_X86
+    case SpanKernel::SSE2:
+        fillFunc = FillSSE2;
+        blendFunc = BlendSSE2;
+        break;
+    case SpanKernel::AVX2:
+        fillFunc = FillAVX2;
+        blendFunc = BlendAVX2;
+        break;
+#endif
+    default:
+        fillFunc = FillScalar;
+        blendFunc = BlendScalar;
+        break;
+    }
+    kernel = k;
+    return true;
+}
+
+const char* SpanWriter::GetKernelName(SpanKernel k) {
+    switch (k) {
+    case SpanKernel::SSE2: return "SSE2";
+    case SpanKernel::AVX2: return "AVX2";
+    default: return "Scalar";
+    }
+}
+
+// 程序启动时选择当前 CPU 支持的最快实现
+static bool SelectBestKernel() {
+    return SpanWriter::SetKernel(SpanKernel::AVX2) ||
+           SpanWriter::SetKernel(SpanKernel::SSE2) ||
+           SpanWriter::SetKernel(SpanKernel::Scalar);
+}
+
+static bool kernelSelected = SelectBestKernel();
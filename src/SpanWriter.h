@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+// 水平像素段写入：把一段连续的 32 位像素写成同一颜色，或以 alpha 混合到目标上
+// 运行时根据 CPU 支持情况选择 AVX2 / SSE2 / 标量实现，三者输出逐位一致
+enum class SpanKernel {
+    Scalar,     // 标量实现（任何平台可用）
+    SSE2,       // 128 位 SSE2
+    AVX2        // 256 位 AVX2
+};
+
+class SpanWriter {
+public:
+    // 把 dst[0, count) 写成 color
+    static void Fill(uint32_t* dst, int count, uint32_t color) { fillFunc(dst, count, color); }
+
+    // dst = (color * alpha + dst * (255 - alpha)) / 255（逐通道，四舍五入）
+    static void Blend(uint32_t* dst, int count, uint32_t color, uint8_t alpha) {
+        if (alpha == 255) {
+            fillFunc(dst, count, color);
+        } else if (alpha != 0) {
+            blendFunc(dst, count, color, alpha);
+        }
+    }
+
+    // 当前 CPU 是否支持某种实现
+    static bool IsSupported(SpanKernel kernel);
+    // 强制使用某种实现（不支持时返回 false，保持原选择），用于基准测试和对比
+    static bool SetKernel(SpanKernel kernel);
+    static SpanKernel GetKernel() { return kernel; }
+    static const char* GetKernelName(SpanKernel kernel);
+
+private:
+    typedef void (*FillFunc)(uint32_t* dst, int count, uint32_t color);
+    typedef void (*BlendFunc)(uint32_t* dst, int count, uint32_t color, uint8_t alpha);
+
+    static FillFunc fillFunc;
+    static BlendFunc blendFunc;
+    static SpanKernel kernel;
+};
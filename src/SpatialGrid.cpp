@@ -0,0 +1,88 @@
+#include "SpatialGrid.h"
+#include <algorithm>
+
+// 向下取整的除法，负坐标也落在正确的单元
+int SpatialGrid::CellOf(int v) {
+    return v >= 0 ? v / CELL_SIZE : -((-v + CELL_SIZE - 1) / CELL_SIZE);
+}
+
+void SpatialGrid::EraseId(std::vector<int>& list, int id) {
+    auto it = std::find(list.begin(), list.end(), id);
+    if (it != list.end()) {
+        *it = list.back();
+        list.pop_back();
+    }
+}
+
+void SpatialGrid::Clear() {
+    entries.clear();
+    cells.clear();
+    largeEntries.clear();
+}
+
+void SpatialGrid::Insert(int id, const Rect& bounds) {
+    if (id < 0) return;
+    if (Contains(id)) Remove(id);
+    if (id >= (int)entries.size()) entries.resize(id + 1);
+
+    Entry& entry = entries[id];
+    entry.bounds = bounds;
+    entry.present = true;
+
+    int cx1 = CellOf(bounds.left), cx2 = CellOf(bounds.right);
+    int cy1 = CellOf(bounds.top), cy2 = CellOf(bounds.bottom);
+    long long cellCount = (long long)(cx2 - cx1 + 1) * (cy2 - cy1 + 1);
+    entry.large = cellCount > MAX_CELLS_PER_ENTRY;
+    if (entry.large) {
+        largeEntries.push_back(id);
+        return;
+    }
+
+    for (int cy = cy1; cy <= cy2; cy++) {
+        for (int cx = cx1; cx <= cx2; cx++) {
+            cells[Key(cx, cy)].push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::Remove(int id) {
+    if (!Contains(id)) return;
+
+    Entry& entry = entries[id];
+    entry.present = false;
+    if (entry.large) {
+        EraseId(largeEntries, id);
+        return;
+    }
+
+    const Rect& bounds = entry.bounds;
+    for (int cy = CellOf(bounds.top); cy <= CellOf(bounds.bottom); cy++) {
+        for (int cx = CellOf(bounds.left); cx <= CellOf(bounds.right); cx++) {
+            auto it = cells.find(Key(cx, cy));
+            if (it == cells.end()) continue;
+            EraseId(it->second, id);
+            if (it->second.empty()) cells.erase(it);
+        }
+    }
+}
+
+void SpatialGrid::Query(const Rect& area, std::vector<int>& out) const {
+    out.clear();
+
+    for (int cy = CellOf(area.top); cy <= CellOf(area.bottom); cy++) {
+        for (int cx = CellOf(area.left); cx <= CellOf(area.right); cx++) {
+            auto it = cells.find(Key(cx, cy));
+            if (it == cells.end()) continue;
+            for (int id : it->second) {
+                if (entries[id].bounds.Intersects(area)) out.push_back(id);
+            }
+        }
+    }
+    for (int id : largeEntries) {
+        if (entries[id].bounds.Intersects(area)) out.push_back(id);
+    }
+
+    // 跨越多个单元的条目可能被重复收集
+    std::sort(out.begin(), out.end(), [](int a, int b) { return a > b; });
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Point.h"
+
+// 均匀网格空间索引
+// 按包围盒把条目登记到它覆盖的每个网格单元，查询时只检查查询区域所在的单元。
+// 覆盖单元过多的大条目单独存放，每次查询都参与检查，避免一个巨大图形占满整张表。
+// 条目编号由调用者分配（Canvas 中就是图形在列表中的下标）。
+class SpatialGrid {
+public:
+    static const int CELL_SIZE = 64;
+    static const int MAX_CELLS_PER_ENTRY = 64;
+
+    void Clear();
+    // 登记或更新条目 id 的包围盒（包含边界）
+    void Insert(int id, const Rect& bounds);
+    void Remove(int id);
+    bool Contains(int id) const { return id >= 0 && id < (int)entries.size() && entries[id].present; }
+
+    // 取出包围盒与 area 相交的条目编号，按编号从大到小排列（即图形从上到下）
+    void Query(const Rect& area, std::vector<int>& out) const;
+
+private:
+    struct Entry {
+        Rect bounds;
+        bool present = false;
+        bool large = false;
+    };
+
+    static int CellOf(int v);
+    static int64_t Key(int cx, int cy) { return ((int64_t)cx << 32) ^ (uint32_t)cy; }
+    static void EraseId(std::vector<int>& list, int id);
+
+    std::vector<Entry> entries;
+    std::unordered_map<int64_t, std::vector<int>> cells;
+    std::vector<int> largeEntries;
+};
@@ -0,0 +1,103 @@
+#include "SplineTessellator.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPLINE_TESSELLATOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+Point SplineTessellator::EvaluateCubic(const Point* cp, double t) {
+    // 三次均匀B样条基函数
+    double f1 = (-t*t*t + 3*t*t - 3*t + 1) / 6.0;
+    double f2 = (3*t*t*t - 6*t*t + 4) / 6.0;
+    double f3 = (-3*t*t*t + 3*t*t + 3*t + 1) / 6.0;
+    double f4 = (t*t*t) / 6.0;
+
+    double x = f1 * cp[0].x + f2 * cp[1].x + f3 * cp[2].x + f4 * cp[3].x;
+    double y = f1 * cp[0].y + f2 * cp[1].y + f3 * cp[2].y + f4 * cp[3].y;
+
+    // 就近取整（lrint 与 SSE2 的 cvtpd 使用相同的舍入模式），负坐标也对称
+    return Point((int)lrint(x), (int)lrint(y));
+}
+
+void SplineTessellator::TessellateCubicDirect(const Point* cp, int steps, std::vector<Point>& out) {
+    for (int j = 0; j <= steps; j++) {
+        out.push_back(EvaluateCubic(cp, (double)j / steps));
+    }
+}
+
+// 曲线的多项式形式 P(t) = a t³ + b t² + c t + d（各系数由控制点线性组合得到），
+// 步长 h 时的初值和各阶差分：
+//   P0 = d
+//   D1 = a h³ + b h² + c h
+//   D2 = 6 a h³ + 2 b h²
+//   D3 = 6 a h³（常数）
+// 每一步 P += D1，D1 += D2，D2 += D3
+void SplineTessellator::TessellateCubic(const Point* cp, int steps, std::vector<Point>& out) {
+    if (steps < 1) steps = 1;
+    double h = 1.0 / steps;
+    double h2 = h * h;
+    double h3 = h2 * h;
+    size_t base = out.size();
+    out.resize(base + steps + 1);
+    Point* dst = out.data() + base;
+
+#ifdef SPLINE_TESSELLATOR_SSE2
+    const __m128d p0 = _mm_setr_pd(cp[0].x, cp[0].y);
+    const __m128d p1 = _mm_setr_pd(cp[1].x, cp[1].y);
+    const __m128d p2 = _mm_setr_pd(cp[2].x, cp[2].y);
+    const __m128d p3 = _mm_setr_pd(cp[3].x, cp[3].y);
+    const __m128d sixth = _mm_set1_pd(1.0 / 6.0);
+    const __m128d three = _mm_set1_pd(3.0);
+    // a = (-p0 + 3p1 - 3p2 + p3) / 6，b = (p0 - 2p1 + p2) / 2，c = (p2 - p0) / 2，d = (p0 + 4p1 + p2) / 6
+    __m128d a = _mm_mul_pd(_mm_add_pd(_mm_sub_pd(p3, p0), _mm_mul_pd(three, _mm_sub_pd(p1, p2))), sixth);
+    __m128d b = _mm_mul_pd(_mm_add_pd(_mm_sub_pd(p0, _mm_add_pd(p1, p1)), p2), _mm_set1_pd(0.5));
+    __m128d c = _mm_mul_pd(_mm_sub_pd(p2, p0), _mm_set1_pd(0.5));
+    __m128d d = _mm_mul_pd(_mm_add_pd(_mm_add_pd(p0, p2), _mm_mul_pd(_mm_set1_pd(4.0), p1)), sixth);
+
+    __m128d ah3 = _mm_mul_pd(a, _mm_set1_pd(h3));
+    __m128d bh2 = _mm_mul_pd(b, _mm_set1_pd(h2));
+    __m128d p = d;
+    __m128d d1 = _mm_add_pd(_mm_add_pd(ah3, bh2), _mm_mul_pd(c, _mm_set1_pd(h)));
+    __m128d d2 = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(6.0), ah3), _mm_add_pd(bh2, bh2));
+    __m128d d3 = _mm_mul_pd(_mm_set1_pd(6.0), ah3);
+    for (int j = 0; j <= steps; j++) {
+        // 与 EvaluateCubic 相同的就近取整
+        __m128i r = _mm_cvtpd_epi32(p);
+        dst[j].x = _mm_cvtsi128_si32(r);
+        dst[j].y = _mm_cvtsi128_si32(_mm_srli_si128(r, 4));
+        p = _mm_add_pd(p, d1);
+        d1 = _mm_add_pd(d1, d2);
+        d2 = _mm_add_pd(d2, d3);
+    }
+#else
+    double px[4] = { (double)cp[0].x, (double)cp[1].x, (double)cp[2].x, (double)cp[3].x };
+    double py[4] = { (double)cp[0].y, (double)cp[1].y, (double)cp[2].y, (double)cp[3].y };
+    double ax = (px[3] - px[0] + 3.0 * (px[1] - px[2])) / 6.0, ay = (py[3] - py[0] + 3.0 * (py[1] - py[2])) / 6.0;
+    double bx = (px[0] - 2.0 * px[1] + px[2]) * 0.5,           by = (py[0] - 2.0 * py[1] + py[2]) * 0.5;
+    double cx = (px[2] - px[0]) * 0.5,                          cy = (py[2] - py[0]) * 0.5;
+    double x = (px[0] + px[2] + 4.0 * px[1]) / 6.0,             y = (py[0] + py[2] + 4.0 * py[1]) / 6.0;
+    double d1x = ax * h3 + bx * h2 + cx * h, d1y = ay * h3 + by * h2 + cy * h;
+    double d2x = 6.0 * ax * h3 + 2.0 * bx * h2, d2y = 6.0 * ay * h3 + 2.0 * by * h2;
+    double d3x = 6.0 * ax * h3, d3y = 6.0 * ay * h3;
+    for (int j = 0; j <= steps; j++) {
+        dst[j] = Point((int)lrint(x), (int)lrint(y));
+        x += d1x; d1x += d2x; d2x += d3x;
+        y += d1y; d1y += d2y; d2y += d3y;
+    }
+#endif
+}
+
+// 步长为 h 的等分折线与曲线的最大偏差不超过 h² · max|P''(t)| / 8（Wang 公式），
+// P''(t) = 6a t + 2b 是 t 的一次函数，最大值在端点取得
+int SplineTessellator::StepsForTolerance(const Point* cp, double tolerance) {
+    double bx = cp[0].x - 2.0 * cp[1].x + cp[2].x;                      // 2b = p0 - 2p1 + p2
+    double by = cp[0].y - 2.0 * cp[1].y + cp[2].y;
+    double ex = cp[1].x - 2.0 * cp[2].x + cp[3].x;                      // 6a + 2b = p1 - 2p2 + p3
+    double ey = cp[1].y - 2.0 * cp[2].y + cp[3].y;
+    double curvature = std::max(sqrt(bx * bx + by * by), sqrt(ex * ex + ey * ey));
+    if (tolerance <= 0.0) return MAX_STEPS;
+    double steps = ceil(sqrt(curvature / (8.0 * tolerance)));
+    return (int)std::min<double>(std::max(steps, 1.0), MAX_STEPS);
+}
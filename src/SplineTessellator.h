@@ -0,0 +1,28 @@
+#pragma once
+#include <vector>
+#include "Point.h"
+
+// 三次均匀 B 样条的细分：一段曲线由 4 个连续控制点 cp[0..3] 决定，参数 t ∈ [0, 1]
+// 等分细分使用前向差分：把曲线写成 t 的三次多项式后，每一步只做三次加法，
+// 没有乘法和基函数计算；x86 上用 SSE2 同时处理 x、y 两个分量
+class SplineTessellator {
+public:
+    // 直接用基函数计算 t 处的点（就近取整，参考实现）
+    static Point EvaluateCubic(const Point* cp, double t);
+
+    // 把一段曲线 steps 等分，追加 steps + 1 个点（t = 0, 1/steps, ..., 1）到 out
+    // 与逐点 EvaluateCubic 的结果相差不超过 1 像素
+    static void TessellateCubic(const Point* cp, int steps, std::vector<Point>& out);
+    // 同上，逐点调用 EvaluateCubic（用于对比和基准测试）
+    static void TessellateCubicDirect(const Point* cp, int steps, std::vector<Point>& out);
+
+    // 自适应细分：按 Wang 公式由曲线的弯曲程度和尺寸求出等分数，
+    // 使折线与曲线的偏差不超过 tolerance 像素（未计入取整误差）
+    static int StepsForTolerance(const Point* cp, double tolerance);
+    static void TessellateCubicAdaptive(const Point* cp, double tolerance, std::vector<Point>& out) {
+        TessellateCubic(cp, StepsForTolerance(cp, tolerance), out);
+    }
+
+    // 自适应细分的等分数上限（极端坐标下防止生成过多点）
+    static const int MAX_STEPS = 1024;
+};
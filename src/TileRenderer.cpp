@@ -0,0 +1,61 @@
+#include "TileRenderer.h"
+#include <algorithm>
+
+TileRenderer::TileRenderer(WorkerPool* pool) : pool(pool) {}
+
+void TileRenderer::Render(RasterTarget& surface, const std::vector<Rect>& bounds, const DrawFunc& draw) {
+    if (surface.IsEmpty() || bounds.empty()) return;
+    if (!pool) pool = &WorkerPool::Shared();
+
+    Rect area = surface.Bounds();
+    int tilesX = (surface.Width() + TILE_SIZE - 1) / TILE_SIZE;
+    int tilesY = (surface.Height() + TILE_SIZE - 1) / TILE_SIZE;
+
+    if (pool->ThreadCount() == 1 || bounds.size() < minParallelItems || tilesX * tilesY == 1) {
+        for (size_t i = 0; i < bounds.size(); i++) {
+            if (bounds[i].Intersects(area)) draw(i, surface);
+        }
+        return;
+    }
+
+    // 分箱：按顺序把每个图元加入它覆盖的所有块
+    if (bins.size() < (size_t)(tilesX * tilesY)) {
+        bins.resize((size_t)tilesX * tilesY);
+    }
+    for (int t = 0; t < tilesX * tilesY; t++) {
+        bins[t].clear();
+    }
+    for (size_t i = 0; i < bounds.size(); i++) {
+        const Rect& b = bounds[i];
+        if (!b.Intersects(area)) continue;
+        int tx0 = (std::max(b.left, area.left) - area.left) / TILE_SIZE;
+        int tx1 = (std::min(b.right, area.right) - area.left) / TILE_SIZE;
+        int ty0 = (std::max(b.top, area.top) - area.top) / TILE_SIZE;
+        int ty1 = (std::min(b.bottom, area.bottom) - area.top) / TILE_SIZE;
+        for (int ty = ty0; ty <= ty1; ty++) {
+            for (int tx = tx0; tx <= tx1; tx++) {
+                bins[ty * tilesX + tx].push_back((uint32_t)i);
+            }
+        }
+    }
+
+    activeTiles.clear();
+    for (int t = 0; t < tilesX * tilesY; t++) {
+        if (!bins[t].empty()) activeTiles.push_back(t);
+    }
+
+    // 各块并行绘制，每块是共享表面上的一个子视图
+    pool->ParallelFor((int)activeTiles.size(), [&](int k) {
+        int t = activeTiles[k];
+        int left = area.left + (t % tilesX) * TILE_SIZE;
+        int top = area.top + (t / tilesX) * TILE_SIZE;
+        int width = std::min(TILE_SIZE, area.right - left + 1);
+        int height = std::min(TILE_SIZE, area.bottom - top + 1);
+
+        RasterTarget tile(surface.Row(top) + (left - area.left), width, height, surface.Stride());
+        tile.SetOrigin(left, top);
+        for (uint32_t index : bins[t]) {
+            draw(index, tile);
+        }
+    });
+}
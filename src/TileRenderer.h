@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Point.h"
+#include "RasterTarget.h"
+#include "WorkerPool.h"
+
+// 分块并行光栅化
+// 把目标表面切成固定大小的块，按包围盒把每个图元分到它覆盖的块中（保持原顺序），
+// 再由线程池并行处理各块：每块是共享表面上的一个子视图，块内按原顺序依次绘制。
+// 各块互不重叠，而所有光栅化算法的结果与裁剪区域无关，因此输出与串行绘制逐位相同。
+class TileRenderer {
+public:
+    static constexpr int TILE_SIZE = 128;
+
+    // 绘制回调：把第 index 个图元画到 tile 上（tile 是表面的子视图，只能写它覆盖的像素）
+    typedef std::function<void(size_t index, RasterTarget& tile)> DrawFunc;
+
+    // pool 为空时使用全局共享线程池（第一次绘制时才创建）
+    explicit TileRenderer(WorkerPool* pool = nullptr);
+
+    // bounds[i] 为第 i 个图元可能触及的像素范围（包含边界）
+    void Render(RasterTarget& surface, const std::vector<Rect>& bounds, const DrawFunc& draw);
+
+    // 图元较少或只有一个线程时直接在整个表面上串行绘制
+    void SetMinParallelItems(size_t count) { minParallelItems = count; }
+
+private:
+    WorkerPool* pool;
+    size_t minParallelItems = 16;
+    std::vector<std::vector<uint32_t>> bins;   // 每块的图元下标（按绘制顺序）
+    std::vector<int> activeTiles;              // 非空的块
+};
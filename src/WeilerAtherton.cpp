@@ -2,35 +2,82 @@
 #include <algorithm>
 #include <cmath>
 
-const double EPSILON = 1e-9;
+// 就近取整的整数除法（d > 0，恰为 .5 时向上取整）
+static int64_t roundDiv(int64_t n, int64_t d) {
+    int64_t q = n / d, r = n % d;
+    if (r < 0) { q--; r += d; }
+    if (2 * r >= d) q++;
+    return q;
+}
+
+// 向数组追加元素前保证容量，扩容时按倍数增长并计入统计
+template <typename T>
+static void ensureCapacity(std::vector<T>& v, size_t size, size_t& growths) {
+    if (size > v.capacity()) {
+        v.reserve(std::max(size, v.capacity() * 2));
+        growths++;
+    }
+}
+
+void ClipGraph::Clear() {
+    vertices.clear();
+    crossings.clear();
+    order.clear();
+    edges.clear();
+    for (int side = 0; side < 2; side++) {
+        for (uint32_t s = 0; s < slabCount; s++) slabs[side][s].clear();
+    }
+    slabCount = 0;
+    subjectSize = 0;
+}
+
+ClipGraph& WeilerAtherton::graph() {
+    static thread_local ClipGraph g;
+    return g;
+}
+
+WeilerAtherton::AllocationStats WeilerAtherton::GetAllocationStats() {
+    AllocationStats stats;
+    stats.vertices = graph().vertexCount;
+    stats.graphArrayGrowths = graph().arrayGrowths;
+    return stats;
+}
 
 // 计算两条线段的交点
 bool WeilerAtherton::lineIntersection(const Point& p1, const Point& p2,
                                       const Point& p3, const Point& p4,
                                       Point& intersection, double& alpha, double& beta) {
-    double x1 = p1.x, y1 = p1.y;
-    double x2 = p2.x, y2 = p2.y;
-    double x3 = p3.x, y3 = p3.y;
-    double x4 = p4.x, y4 = p4.y;
+    // 坐标差不超过 2^20 时各乘积都在 64 位整数内精确表示
+    int64_t x1 = p1.x, y1 = p1.y;
+    int64_t x2 = p2.x, y2 = p2.y;
+    int64_t x3 = p3.x, y3 = p3.y;
+    int64_t x4 = p4.x, y4 = p4.y;
     
-    double denom = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
+    int64_t denom = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
     
-    if (std::abs(denom) < EPSILON) {
+    if (denom == 0) {
         return false; // 平行或重合
     }
     
-    alpha = ((x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4)) / denom;
-    beta = ((x1 - x3) * (y1 - y2) - (y1 - y3) * (x1 - x2)) / denom;
+    int64_t na = (x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4);
+    int64_t nb = (x1 - x3) * (y1 - y2) - (y1 - y3) * (x1 - x2);
+    if (denom < 0) {
+        denom = -denom;
+        na = -na;
+        nb = -nb;
+    }
     
-    // 检查交点是否在两条线段上
-    if (alpha > EPSILON && alpha < 1.0 - EPSILON && 
-        beta > EPSILON && beta < 1.0 - EPSILON) {
-        intersection.x = x1 + alpha * (x2 - x1);
-        intersection.y = y1 + alpha * (y2 - y1);
-        return true;
+    // 检查交点是否在两条线段内部（不含端点）
+    if (na <= 0 || na >= denom || nb <= 0 || nb >= denom) {
+        return false;
     }
     
-    return false;
+    // 参数是同一有理数的正确舍入，交点坐标就近取整，与矩形快速路径的结果逐位一致
+    alpha = (double)na / (double)denom;
+    beta = (double)nb / (double)denom;
+    intersection.x = (int)(x1 + roundDiv(na * (x2 - x1), denom));
+    intersection.y = (int)(y1 + roundDiv(na * (y2 - y1), denom));
+    return true;
 }
 
 // 判断点是否在多边形内部 (射线法)
@@ -54,208 +101,304 @@ bool WeilerAtherton::isPointInPolygon(const Point& p, const std::vector<Point>&
     return (count % 2) == 1;
 }
 
-// 构建顶点链表
-Vertex* WeilerAtherton::buildVertexList(const std::vector<Point>& poly) {
-    if (poly.empty()) return nullptr;
-    
-    Vertex* head = new Vertex(poly[0]);
-    Vertex* current = head;
-    
-    for (size_t i = 1; i < poly.size(); i++) {
-        Vertex* v = new Vertex(poly[i]);
-        current->next = v;
-        current = v;
-    }
-    current->next = head; // 形成环形链表
-    
-    return head;
+// 矩形内部的判断与射线法对该矩形的结果相同：左、上边界算在内，右、下边界不算
+bool WeilerAtherton::isPointInRect(const Point& p, const Rect& rect) {
+    return p.x >= rect.left && p.x < rect.right && p.y >= rect.top && p.y < rect.bottom;
 }
 
-// 插入交点
-void WeilerAtherton::insertIntersections(Vertex* subjectHead, Vertex* clipHead,
-                                         const std::vector<Point>& subject, const std::vector<Point>& clip) {
-    Vertex* s = subjectHead;
-    int sIndex = 0;
-    
-    do {
-        Vertex* sNext = s->next;
-        Point p1 = s->point;
-        Point p2 = sNext->point;
-        
-        std::vector<std::pair<Vertex*, double>> intersections;
-        
-        Vertex* c = clipHead;
-        int cIndex = 0;
+// subject 边 (u1,v1)→(u2,v2) 与轴对齐线段 v = V（u 从 ua 到 ub）的严格相交。
+// 水平边界时 u、v 即 x、y，竖直边界时两者互换。alpha、beta 与 lineIntersection 对同一对线段的结果相同
+static bool crossAxisLine(int64_t u1, int64_t v1, int64_t u2, int64_t v2,
+                          int64_t V, int64_t ua, int64_t ub,
+                          double& alpha, double& beta, int& u) {
+    if (!((v1 < V && V < v2) || (v2 < V && V < v1))) return false;
+    int64_t dv = v2 - v1, du = u2 - u1, t = V - v1;
+    if (dv < 0) { dv = -dv; t = -t; }
+    // 交点到 ua 的距离为 num / (dv · (ub - ua)) · (ub - ua)
+    int64_t num = (u1 - ua) * dv + t * du, den = (ub - ua) * dv;
+    if (den < 0) { num = -num; den = -den; }
+    if (num <= 0 || num >= den) return false;
+    alpha = (double)t / (double)dv;
+    beta = (double)num / (double)den;
+    u = (int)(u1 + roundDiv(t * du, dv));
+    return true;
+}
+
+// 区域编码（与 Cohen-Sutherland 相同，边界算在内部）
+static int outCode(const Point& p, const Rect& rect) {
+    return (p.x < rect.left ? 1 : p.x > rect.right ? 2 : 0) | (p.y < rect.top ? 4 : p.y > rect.bottom ? 8 : 0);
+}
+
+// 矩形窗口的交点：两端编码相与非零（在同一侧外部）或都为零（都在闭矩形内）的边不可能与边界严格相交，直接跳过；
+// 其余边只与四条边界按整数运算求交。窗口边界顺序与 clip(subject, 矩形多边形) 相同：上、右、下、左
+void WeilerAtherton::rectCrossings(const std::vector<Point>& subject, const Rect& rect, ClipGraph& g) {
+    uint32_t ns = (uint32_t)subject.size();
+    for (uint32_t i = 0; i < ns; i++) {
+        const Point& p1 = subject[i];
+        const Point& p2 = subject[i + 1 == ns ? 0 : i + 1];
+        int c1 = outCode(p1, rect), c2 = outCode(p2, rect);
+        if ((c1 & c2) != 0 || (c1 | c2) == 0) continue;
         
-        do {
-            Vertex* cNext = c->next;
-            Point p3 = c->point;
-            Point p4 = cNext->point;
-            
-            Point inter;
-            double alpha, beta;
-            
-            if (lineIntersection(p1, p2, p3, p4, inter, alpha, beta)) {
-                // 在 subject 边上创建交点
-                Vertex* sInter = new Vertex(inter, VertexType::INTERSECTION);
-                sInter->alpha = alpha;
-                
-                // 在 clip 边上创建交点
-                Vertex* cInter = new Vertex(inter, VertexType::INTERSECTION);
-                cInter->alpha = beta;
-                
-                // 建立邻居关系
-                sInter->neighbor = cInter;
-                cInter->neighbor = sInter;
-                
-                intersections.push_back({sInter, alpha});
-                
-                // 将交点插入 clip 链表
-                std::vector<std::pair<Vertex*, double>> clipIntersections;
-                Vertex* temp = c->next;
-                while (temp != cNext) {
-                    if (temp->type == VertexType::INTERSECTION) {
-                        clipIntersections.push_back({temp, temp->alpha});
-                    }
-                    temp = temp->next;
+        for (uint32_t j = 0; j < 4; j++) {
+            Crossing c;
+            int u;
+            bool hit;
+            switch (j) {
+            case 0:     // 上边 (left, top) → (right, top)
+                hit = crossAxisLine(p1.x, p1.y, p2.x, p2.y, rect.top, rect.left, rect.right, c.alpha, c.beta, u);
+                c.point = Point(u, rect.top);
+                break;
+            case 1:     // 右边 (right, top) → (right, bottom)
+                hit = crossAxisLine(p1.y, p1.x, p2.y, p2.x, rect.right, rect.top, rect.bottom, c.alpha, c.beta, u);
+                c.point = Point(rect.right, u);
+                break;
+            case 2:     // 下边 (right, bottom) → (left, bottom)
+                hit = crossAxisLine(p1.x, p1.y, p2.x, p2.y, rect.bottom, rect.right, rect.left, c.alpha, c.beta, u);
+                c.point = Point(u, rect.bottom);
+                break;
+            default:    // 左边 (left, bottom) → (left, top)
+                hit = crossAxisLine(p1.y, p1.x, p2.y, p2.x, rect.left, rect.bottom, rect.top, c.alpha, c.beta, u);
+                c.point = Point(rect.left, u);
+                break;
+            }
+            if (hit) {
+                c.subjectEdge = i;
+                c.clipEdge = j;
+                ensureCapacity(g.crossings, g.crossings.size() + 1, g.arrayGrowths);
+                g.crossings.push_back(c);
+            }
+        }
+    }
+}
+
+// 求出两个多边形所有边之间的交点
+void WeilerAtherton::findCrossings(const std::vector<Point>& subject, const std::vector<Point>& clip,
+                                   CrossingSearch search, ClipGraph& g) {
+    uint32_t ns = (uint32_t)subject.size(), nc = (uint32_t)clip.size();
+    if (search == CrossingSearch::SWEEP || (search == CrossingSearch::AUTO && (size_t)ns * nc > SWEEP_THRESHOLD)) {
+        sweepCrossings(subject, clip, g);
+        return;
+    }
+    for (uint32_t i = 0; i < ns; i++) {
+        const Point& p1 = subject[i];
+        const Point& p2 = subject[i + 1 == ns ? 0 : i + 1];
+        for (uint32_t j = 0; j < nc; j++) {
+            Crossing c;
+            if (lineIntersection(p1, p2, clip[j], clip[j + 1 == nc ? 0 : j + 1], c.point, c.alpha, c.beta)) {
+                c.subjectEdge = i;
+                c.clipEdge = j;
+                ensureCapacity(g.crossings, g.crossings.size() + 1, g.arrayGrowths);
+                g.crossings.push_back(c);
+            }
+        }
+    }
+}
+
+// 相交的边对一定 y 范围重叠：边按 ymin 排序后依次加入扫描线，加入时与另一多边形的活动边求交，
+// ymax 已在扫描线之上的活动边顺便移除。活动边按 x 分槽存放：一条边放入它的 x 范围覆盖的每个槽，
+// 加入时只查看自己覆盖的槽，所以 x 范围不重叠的活动边（梳齿状交错的长边等）不会被逐一检查。
+// 一对边可能同在多个槽中，只在两者 x 重叠部分左端所在的槽里求交，每对边只检查一次，交点与两两求交相同。
+// 槽宽取所有边的平均宽度，边放入的槽数之和不超过边数的两倍
+void WeilerAtherton::sweepCrossings(const std::vector<Point>& subject, const std::vector<Point>& clip, ClipGraph& g) {
+    uint32_t ns = (uint32_t)subject.size(), nc = (uint32_t)clip.size();
+    ensureCapacity(g.edges, (size_t)ns + nc, g.arrayGrowths);
+    auto addEdges = [&](const std::vector<Point>& poly, uint32_t base) {
+        uint32_t n = (uint32_t)poly.size();
+        for (uint32_t i = 0; i < n; i++) {
+            const Point& a = poly[i];
+            const Point& b = poly[i + 1 == n ? 0 : i + 1];
+            g.edges.push_back({ std::min(a.x, b.x), std::max(a.x, b.x), std::min(a.y, b.y), std::max(a.y, b.y), base + i });
+        }
+    };
+    addEdges(subject, 0);
+    addEdges(clip, ns);
+    std::sort(g.edges.begin(), g.edges.end(), [](const SweepEdge& a, const SweepEdge& b) {
+        return a.ymin < b.ymin;
+    });
+
+    // 槽的划分：[xlo, xlo + width) 为第 0 槽，槽数不超过边数的 4 倍
+    int64_t xlo = g.edges[0].xmin, xhi = g.edges[0].xmax, widthSum = 0;
+    for (const SweepEdge& edge : g.edges) {
+        xlo = std::min<int64_t>(xlo, edge.xmin);
+        xhi = std::max<int64_t>(xhi, edge.xmax);
+        widthSum += (int64_t)edge.xmax - edge.xmin;
+    }
+    int64_t total = (int64_t)g.edges.size();
+    int64_t width = std::max<int64_t>(1, (widthSum + total - 1) / total);
+    int64_t count = (xhi - xlo) / width + 1;
+    if (count > 4 * total) {
+        count = 4 * total;
+        width = (xhi - xlo) / count + 1;
+    }
+    auto slabOf = [&](int x) { return (uint32_t)(((int64_t)x - xlo) / width); };
+
+    g.slabCount = (uint32_t)count;
+    for (int side = 0; side < 2; side++) {
+        if (g.slabs[side].size() < g.slabCount) {
+            ensureCapacity(g.slabs[side], g.slabCount, g.arrayGrowths);
+            g.slabs[side].resize(g.slabCount);
+        }
+    }
+
+    // 活动边记录的是 edges 中的位置
+    for (uint32_t e = 0; e < (uint32_t)g.edges.size(); e++) {
+        const SweepEdge& edge = g.edges[e];
+        bool isSubject = edge.index < ns;
+        uint32_t first = slabOf(edge.xmin), last = slabOf(edge.xmax);
+        for (uint32_t s = first; s <= last; s++) {
+            std::vector<uint32_t>& others = g.slabs[isSubject ? 1 : 0][s];
+            for (size_t a = 0; a < others.size();) {
+                const SweepEdge& other = g.edges[others[a]];
+                if (other.ymax < edge.ymin) {
+                    others[a] = others.back();
+                    others.pop_back();
+                    continue;
                 }
-                clipIntersections.push_back({cInter, beta});
-                
-                // 按 alpha 排序
-                std::sort(clipIntersections.begin(), clipIntersections.end(),
-                         [](const std::pair<Vertex*, double>& a, const std::pair<Vertex*, double>& b) { 
-                             return a.second < b.second; 
-                         });
-                
-                // 重新插入到 clip 链表
-                Vertex* cCurrent = c;
-                for (const auto& pair : clipIntersections) {
-                    pair.first->next = cCurrent->next;
-                    cCurrent->next = pair.first;
-                    cCurrent = pair.first;
+                a++;
+                if (other.xmax < edge.xmin || other.xmin > edge.xmax) continue;
+                if (slabOf(std::max(edge.xmin, other.xmin)) != s) continue;
+
+                uint32_t i = isSubject ? edge.index : other.index;
+                uint32_t j = (isSubject ? other.index : edge.index) - ns;
+                Crossing c;
+                if (lineIntersection(subject[i], subject[i + 1 == ns ? 0 : i + 1],
+                                     clip[j], clip[j + 1 == nc ? 0 : j + 1], c.point, c.alpha, c.beta)) {
+                    c.subjectEdge = i;
+                    c.clipEdge = j;
+                    ensureCapacity(g.crossings, g.crossings.size() + 1, g.arrayGrowths);
+                    g.crossings.push_back(c);
                 }
-                cCurrent->next = cNext;
             }
-            
-            c = cNext;
-            cIndex++;
-        } while (c != clipHead);
-        
-        // 按 alpha 值排序交点
-        std::sort(intersections.begin(), intersections.end(),
-                 [](const std::pair<Vertex*, double>& a, const std::pair<Vertex*, double>& b) { 
-                     return a.second < b.second; 
-                 });
-        
-        // 将排序后的交点插入 subject 链表
-        Vertex* sCurrent = s;
-        for (const auto& pair : intersections) {
-            pair.first->next = sCurrent->next;
-            sCurrent->next = pair.first;
-            sCurrent = pair.first;
+            std::vector<uint32_t>& own = g.slabs[isSubject ? 0 : 1][s];
+            ensureCapacity(own, own.size() + 1, g.arrayGrowths);
+            own.push_back(e);
         }
-        
-        s = sNext;
-        sIndex++;
-    } while (s != subjectHead);
+    }
+}
+
+// 把一个多边形的顶点和其边上的交点按行进顺序放入图中：
+// 交点先按 (所在边, 参数位置) 整体排序一次，再与原顶点归并（参数相同时按另一条边排，与求交顺序无关）
+void WeilerAtherton::buildGraph(const std::vector<Point>& subject, const std::vector<Point>& clip, ClipGraph& g) {
+    uint32_t k = (uint32_t)g.crossings.size();
+    ensureCapacity(g.vertices, subject.size() + clip.size() + 2 * (size_t)k, g.arrayGrowths);
+    ensureCapacity(g.order, k, g.arrayGrowths);
+
+    auto appendRing = [&](const std::vector<Point>& poly, bool isSubject) {
+        const std::vector<Crossing>& cs = g.crossings;
+        g.order.resize(k);
+        for (uint32_t h = 0; h < k; h++) g.order[h] = h;
+        if (isSubject) {
+            std::sort(g.order.begin(), g.order.end(), [&](uint32_t a, uint32_t b) {
+                if (cs[a].subjectEdge != cs[b].subjectEdge) return cs[a].subjectEdge < cs[b].subjectEdge;
+                if (cs[a].alpha != cs[b].alpha) return cs[a].alpha < cs[b].alpha;
+                return cs[a].clipEdge < cs[b].clipEdge;
+            });
+        } else {
+            std::sort(g.order.begin(), g.order.end(), [&](uint32_t a, uint32_t b) {
+                if (cs[a].clipEdge != cs[b].clipEdge) return cs[a].clipEdge < cs[b].clipEdge;
+                if (cs[a].beta != cs[b].beta) return cs[a].beta < cs[b].beta;
+                return cs[a].subjectEdge < cs[b].subjectEdge;
+            });
+        }
+
+        uint32_t first = (uint32_t)g.vertices.size();
+        uint32_t h = 0;
+        for (uint32_t i = 0; i < (uint32_t)poly.size(); i++) {
+            g.vertices.emplace_back(poly[i]);
+            for (; h < k; h++) {
+                Crossing& c = g.crossings[g.order[h]];
+                if ((isSubject ? c.subjectEdge : c.clipEdge) != i) break;
+                (isSubject ? c.subjectVertex : c.clipVertex) = (uint32_t)g.vertices.size();
+                g.vertices.emplace_back(c.point, VertexType::INTERSECTION);
+            }
+        }
+        // 环内顶点连续存放，next 只在末尾回绕
+        uint32_t last = (uint32_t)g.vertices.size() - 1;
+        for (uint32_t v = first; v < last; v++) g.vertices[v].next = v + 1;
+        g.vertices[last].next = first;
+    };
+
+    appendRing(subject, true);
+    g.subjectSize = (uint32_t)g.vertices.size();
+    appendRing(clip, false);
+
+    // 建立邻居关系
+    for (const Crossing& c : g.crossings) {
+        g.vertices[c.subjectVertex].neighbor = c.clipVertex;
+        g.vertices[c.clipVertex].neighbor = c.subjectVertex;
+    }
+    g.vertexCount += g.vertices.size();
 }
 
 // 标记进入/退出点
-void WeilerAtherton::markEntryExit(Vertex* subjectHead, const std::vector<Point>& clipPoly) {
-    Vertex* v = subjectHead;
-    bool inside = isPointInPolygon(v->point, clipPoly);
-    
-    do {
-        if (v->type == VertexType::INTERSECTION) {
-            v->isEntry = !inside;
+void WeilerAtherton::markEntryExit(ClipGraph& g, bool startInside) {
+    bool inside = startInside;
+
+    for (uint32_t v = 0; v < g.subjectSize; v++) {
+        Vertex& vertex = g.vertices[v];
+        if (vertex.type == VertexType::INTERSECTION) {
+            vertex.isEntry = !inside;
             inside = !inside;
         }
-        v = v->next;
-    } while (v != subjectHead);
+    }
 }
 
 // 遍历并提取裁剪后的多边形
-std::vector<std::vector<Point>> WeilerAtherton::tracePolygons(Vertex* subjectHead) {
+std::vector<std::vector<Point>> WeilerAtherton::tracePolygons(ClipGraph& g) {
     std::vector<std::vector<Point>> result;
-    
-    Vertex* v = subjectHead;
-    do {
-        if (v->type == VertexType::INTERSECTION && v->isEntry && !v->visited) {
+    std::vector<Vertex>& vs = g.vertices;
+
+    for (uint32_t v = 0; v < g.subjectSize; v++) {
+        if (vs[v].type == VertexType::INTERSECTION && vs[v].isEntry && !vs[v].visited) {
             std::vector<Point> poly;
-            Vertex* current = v;
-            
+            uint32_t current = v;
+
             do {
-                current->visited = true;
-                current->neighbor->visited = true;
-                poly.push_back(current->point);
-                
-                if (current->isEntry) {
-                    // 沿着 subject 多边形前进
-                    current = current->next;
-                    while (current->type != VertexType::INTERSECTION) {
-                        poly.push_back(current->point);
-                        current = current->next;
-                    }
-                } else {
-                    // 沿着 clip 多边形前进
-                    current = current->next;
-                    while (current->type != VertexType::INTERSECTION) {
-                        poly.push_back(current->point);
-                        current = current->next;
-                    }
+                vs[current].visited = true;
+                vs[vs[current].neighbor].visited = true;
+                poly.push_back(vs[current].point);
+
+                // 进入点沿 subject 前进，退出点沿 clip 前进，都走到下一个交点为止
+                current = vs[current].next;
+                while (vs[current].type != VertexType::INTERSECTION) {
+                    poly.push_back(vs[current].point);
+                    current = vs[current].next;
                 }
-                
+
                 // 切换到另一个多边形
-                current = current->neighbor;
-                
-            } while (current != v && !current->visited);
-            
+                current = vs[current].neighbor;
+
+            } while (current != v && !vs[current].visited);
+
             if (poly.size() >= 3) {
                 result.push_back(poly);
             }
         }
-        v = v->next;
-    } while (v != subjectHead);
-    
-    return result;
-}
+    }
 
-// 释放顶点链表
-void WeilerAtherton::freeVertexList(Vertex* head) {
-    if (!head) return;
-    
-    Vertex* current = head;
-    do {
-        Vertex* next = current->next;
-        delete current;
-        current = next;
-    } while (current != head);
+    return result;
 }
 
-// 执行 Weiler-Atherton 裁剪
-std::vector<std::vector<Point>> WeilerAtherton::clip(const std::vector<Point>& subject, const std::vector<Point>& clipPoly) {
-    if (subject.size() < 3 || clipPoly.size() < 3) {
-        return {};
-    }
-    
-    // 构建顶点链表
-    Vertex* subjectHead = buildVertexList(subject);
-    Vertex* clipHead = buildVertexList(clipPoly);
+// 由已求出的交点构建顶点图并提取结果；rect 非空时裁剪窗口为该矩形（clipPoly 为其四个角）
+std::vector<std::vector<Point>> WeilerAtherton::assemble(const std::vector<Point>& subject, const std::vector<Point>& clipPoly,
+                                                         const Rect* rect, ClipGraph& g) {
+    auto inside = [&](const Point& p) {
+        return rect ? isPointInRect(p, *rect) : isPointInPolygon(p, clipPoly);
+    };
     
-    // 插入交点
-    insertIntersections(subjectHead, clipHead, subject, clipPoly);
+    buildGraph(subject, clipPoly, g);
     
     // 标记进入/退出点
-    markEntryExit(subjectHead, clipPoly);
+    markEntryExit(g, inside(subject[0]));
     
     // 提取裁剪后的多边形
-    std::vector<std::vector<Point>> result = tracePolygons(subjectHead);
+    std::vector<std::vector<Point>> result = tracePolygons(g);
     
     // 如果没有交点，检查是否完全包含
     if (result.empty()) {
         bool subjectInClip = true;
         for (const auto& p : subject) {
-            if (!isPointInPolygon(p, clipPoly)) {
+            if (!inside(p)) {
                 subjectInClip = false;
                 break;
             }
@@ -265,9 +408,48 @@ std::vector<std::vector<Point>> WeilerAtherton::clip(const std::vector<Point>& s
         }
     }
     
-    // 释放内存
-    freeVertexList(subjectHead);
-    freeVertexList(clipHead);
-    
     return result;
 }
+
+// 执行 Weiler-Atherton 裁剪
+std::vector<std::vector<Point>> WeilerAtherton::clip(const std::vector<Point>& subject, const std::vector<Point>& clipPoly,
+                                                     CrossingSearch search) {
+    if (subject.size() < 3 || clipPoly.size() < 3) {
+        return {};
+    }
+    
+    // 图的存储属于当前线程，离开时清空以便复用
+    ClipGraph& g = graph();
+    struct GraphReset {
+        ClipGraph& graph;
+        ~GraphReset() { graph.Clear(); }
+    } reset{g};
+    
+    findCrossings(subject, clipPoly, search, g);
+    return assemble(subject, clipPoly, nullptr, g);
+}
+
+// 矩形窗口的 Weiler-Atherton 裁剪
+std::vector<std::vector<Point>> WeilerAtherton::clip(const std::vector<Point>& subject, const Rect& rect) {
+    static thread_local std::vector<Point> corners(4);
+    corners[0] = Point(rect.left, rect.top);
+    corners[1] = Point(rect.right, rect.top);
+    corners[2] = Point(rect.right, rect.bottom);
+    corners[3] = Point(rect.left, rect.bottom);
+    // 退化或未规范化的矩形走一般路径
+    if (rect.left >= rect.right || rect.top >= rect.bottom) {
+        return clip(subject, corners);
+    }
+    if (subject.size() < 3) {
+        return {};
+    }
+    
+    ClipGraph& g = graph();
+    struct GraphReset {
+        ClipGraph& graph;
+        ~GraphReset() { graph.Clear(); }
+    } reset{g};
+    
+    rectCrossings(subject, rect, g);
+    return assemble(subject, corners, &rect, g);
+}
@@ -4,6 +4,8 @@
 #include "Point.h"
 #include <vector>
 #include <memory>
+#include <cstddef>
+#include <cstdint>
 
 // 顶点类型枚举
 enum class VertexType {
@@ -11,53 +13,121 @@ enum class VertexType {
     INTERSECTION   // 交点
 };
 
-// 顶点节点
+// 顶点节点（在 ClipGraph::vertices 中按环的顺序连续存放）
 struct Vertex {
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
     Point point;
     VertexType type;
     bool isEntry;           // 交点是否为进入点
-    Vertex* next;           // 同一多边形的下一个顶点
-    Vertex* neighbor;       // 对应另一个多边形的交点
     bool visited;           // 是否已访问
-    double alpha;           // 交点在边上的参数位置 [0,1]
-    
+    uint32_t next;          // 同一多边形的下一个顶点（下标）
+    uint32_t neighbor;      // 对应另一个多边形的交点（下标，普通顶点为 NONE）
+
     Vertex(const Point& p, VertexType t = VertexType::NORMAL)
-        : point(p), type(t), isEntry(false), next(nullptr), 
-          neighbor(nullptr), visited(false), alpha(0.0) {}
+        : point(p), type(t), isEntry(false), visited(false),
+          next(NONE), neighbor(NONE) {}
+};
+
+// 求交点的方式
+enum class CrossingSearch {
+    AUTO,       // 按两多边形边数之积选择（见 WeilerAtherton::SWEEP_THRESHOLD）
+    PAIRWISE,   // 两两求交
+    SWEEP       // 扫描求交
+};
+
+// 一条 subject 边与一条 clip 边的交点
+struct Crossing {
+    Point point;
+    uint32_t subjectEdge;   // subject 边的起点下标
+    uint32_t clipEdge;      // clip 边的起点下标
+    double alpha;           // 交点在 subject 边上的参数位置 (0,1)
+    double beta;            // 交点在 clip 边上的参数位置 (0,1)
+    uint32_t subjectVertex; // 交点在图中的两个顶点下标
+    uint32_t clipVertex;
+};
+
+// 扫描求交时的一条边（subject 的边在前，clip 的边下标加上 subject 边数）
+struct SweepEdge {
+    int xmin, xmax, ymin, ymax;
+    uint32_t index;
+};
+
+// 裁剪用的顶点图：subject 环在前、clip 环在后，每个环内顶点与交点按行进顺序连续存放，
+// 互相用 32 位下标引用。数组在当前线程的各次裁剪间复用
+struct ClipGraph {
+    std::vector<Vertex> vertices;
+    std::vector<Crossing> crossings;
+    std::vector<uint32_t> order;          // 交点按边排序后的次序
+    std::vector<SweepEdge> edges;         // 扫描求交：按 ymin 排序的边
+    std::vector<std::vector<uint32_t>> slabs[2];    // 扫描线上 subject / clip 的活动边，按 x 分槽存放
+    uint32_t slabCount = 0;               // 本次扫描使用的槽数
+    uint32_t subjectSize = 0;             // subject 环的顶点数（含交点）
+
+    // 累计统计：放入图中的顶点数和图中各数组扩容的次数
+    size_t vertexCount = 0;
+    size_t arrayGrowths = 0;
+
+    void Clear();
 };
 
 class WeilerAtherton {
 public:
+    // 当前线程的分配统计（只统计顶点图；每次裁剪返回的结果多边形另有各自的分配，不计在内）
+    struct AllocationStats {
+        size_t vertices = 0;            // 放入图中的顶点数（逐个 new 时的分配次数）
+        size_t graphArrayGrowths = 0;   // 顶点图中各数组扩容的次数
+    };
+    static AllocationStats GetAllocationStats();
+
     // 执行 Weiler-Atherton 裁剪算法
     // subject: 被裁剪的多边形
     // clipPoly: 裁剪窗口多边形
+    // search: 求交点的方式（两种方式的结果相同，除 AUTO 外只用于对照检查）
     // 返回：裁剪后的多边形列表（可能有多个）
-    static std::vector<std::vector<Point>> clip(const std::vector<Point>& subject, const std::vector<Point>& clipPoly);
+    static std::vector<std::vector<Point>> clip(const std::vector<Point>& subject, const std::vector<Point>& clipPoly,
+                                                CrossingSearch search = CrossingSearch::AUTO);
+    // 轴对齐矩形窗口的快速路径：按区域编码跳过不可能相交的边，用整数运算求与边界的交点，
+    // 结果与以矩形四个角（上左、上右、下右、下左）为裁剪多边形时相同
+    static std::vector<std::vector<Point>> clip(const std::vector<Point>& subject, const Rect& rect);
     
+    // 两多边形边数之积不超过此值时两两求交，否则扫描求交
+    static constexpr size_t SWEEP_THRESHOLD = 256;
+
 private:
     // 计算两条线段的交点
     static bool lineIntersection(const Point& p1, const Point& p2,
                                   const Point& p3, const Point& p4,
                                   Point& intersection, double& alpha, double& beta);
-    
+
     // 判断点是否在多边形内部
     static bool isPointInPolygon(const Point& p, const std::vector<Point>& poly);
-    
-    // 构建顶点链表
-    static Vertex* buildVertexList(const std::vector<Point>& poly);
-    
-    // 插入交点
-    static void insertIntersections(Vertex* subjectHead, Vertex* clipHead,
-                                    const std::vector<Point>& subject, const std::vector<Point>& clip);
-    
-    // 标记进入/退出点
-    static void markEntryExit(Vertex* subjectHead, const std::vector<Point>& clipPoly);
-    
+    static bool isPointInRect(const Point& p, const Rect& rect);
+
+    // 当前线程的顶点图（各次裁剪复用）
+    static ClipGraph& graph();
+
+    // 求出两个多边形所有边之间的交点
+    static void findCrossings(const std::vector<Point>& subject, const std::vector<Point>& clip,
+                              CrossingSearch search, ClipGraph& g);
+    // 矩形窗口四条边界上的交点
+    static void rectCrossings(const std::vector<Point>& subject, const Rect& rect, ClipGraph& g);
+    // 沿 y 方向扫描：边按 ymin 依次加入，只与另一多边形中 y、x 范围都重叠的活动边求交。
+    // 活动边放入它的 x 范围覆盖的各个等宽竖条（槽宽取边的平均宽度），加入一条边时只查看同槽的活动边
+    static void sweepCrossings(const std::vector<Point>& subject, const std::vector<Point>& clip, ClipGraph& g);
+
+    // 把交点按所在边和参数位置排序后与原顶点一起依次放入图中，连好 next/neighbor
+    static void buildGraph(const std::vector<Point>& subject, const std::vector<Point>& clip, ClipGraph& g);
+
+    // 标记进入/退出点（startInside 为 subject 第一个顶点是否在裁剪区域内）
+    static void markEntryExit(ClipGraph& g, bool startInside);
+
     // 遍历并提取裁剪后的多边形
-    static std::vector<std::vector<Point>> tracePolygons(Vertex* subjectHead);
+    static std::vector<std::vector<Point>> tracePolygons(ClipGraph& g);
     
-    // 释放顶点链表
-    static void freeVertexList(Vertex* head);
+    // 建图、标记并提取结果（交点已求出）
+    static std::vector<std::vector<Point>> assemble(const std::vector<Point>& subject, const std::vector<Point>& clipPoly,
+                                                    const Rect* rect, ClipGraph& g);
 };
 
 #endif // WEILER_ATHERTON_H
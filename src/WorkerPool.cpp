@@ -0,0 +1,81 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency();
+    }
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+WorkerPool& WorkerPool::Shared() {
+    static WorkerPool pool;
+    return pool;
+}
+
+void WorkerPool::ParallelFor(int count, const std::function<void(int)>& body) {
+    if (count <= 0) return;
+
+    // 没有工作线程或只有一项时直接在当前线程执行
+    if (workers.empty() || count == 1) {
+        for (int i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &body;
+        jobCount = count;
+        next.store(0);
+        busy = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    RunJob();
+
+    // body 的生命周期只到本函数返回，必须等所有工作线程离开 RunJob
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::RunJob() {
+    int i;
+    while ((i = next.fetch_add(1)) < jobCount) {
+        (*job)(i);
+    }
+}
+
+void WorkerPool::WorkerLoop() {
+    unsigned long long seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [&] { return stop || generation != seen; });
+        if (stop) return;
+        seen = generation;
+
+        lock.unlock();
+        RunJob();
+        lock.lock();
+
+        if (--busy == 0) {
+            done.notify_one();
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 简单的工作线程池：ParallelFor 把 [0, count) 的下标分给各线程执行，调用线程也参与，
+// 返回时所有下标都已处理完。下标按原子计数器逐个领取，负载不均时自动平衡。
+// 同一时刻只执行一个任务（多个线程同时提交会排队）；body 内不能再调用同一线程池的 ParallelFor。
+class WorkerPool {
+public:
+    // threadCount：参与计算的线程总数（含调用线程），0 表示使用全部硬件线程
+    explicit WorkerPool(int threadCount = 0);
+    ~WorkerPool();
+
+    int ThreadCount() const { return (int)workers.size() + 1; }
+
+    void ParallelFor(int count, const std::function<void(int)>& body);
+
+    // 全局共享的线程池（首次使用时创建）
+    static WorkerPool& Shared();
+
+private:
+    void WorkerLoop();
+    void RunJob();
+
+    std::vector<std::thread> workers;
+    std::mutex submitMutex;            // 串行化任务提交
+    std::mutex mutex;
+    std::condition_variable wake;      // 通知工作线程有新任务
+    std::condition_variable done;      // 通知提交者工作线程已全部完成
+    bool stop = false;
+    unsigned long long generation = 0; // 任务编号，工作线程据此判断是否有新任务
+    int busy = 0;                      // 尚未完成当前任务的工作线程数
+
+    const std::function<void(int)>* job = nullptr;
+    int jobCount = 0;
+    std::atomic<int> next{0};
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+};